@@ -0,0 +1,15 @@
+#version 300 es
+precision mediump float;
+
+in vec2 texCoords;
+in vec4 vertexColor;
+out vec4 fragColor;
+
+uniform sampler2D image;
+
+void main()
+{
+    // costume cache cells are premultiplied, blending expects straight alpha
+    vec4 texel = texture(image, texCoords);
+    fragColor = texel.a > 0.0 ? vec4(texel.rgb / texel.a, texel.a) * vertexColor : vec4(0.0);
+}
@@ -0,0 +1,34 @@
+#version 300 es
+precision mediump float;
+precision mediump sampler2DArray;
+
+in vec2 texCoords;
+flat in vec4 faceLegsTorsoHat;
+flat in float hands;
+flat in float opacity;
+out vec4 fragColor;
+
+uniform sampler2DArray layers;
+
+// stack one layer on top of the premultiplied result so far
+vec4 over(vec4 acc, float slice)
+{
+    if (slice < 0.0)
+        return acc;
+
+    vec4 layer = texture(layers, vec3(texCoords, slice));
+    return vec4(layer.rgb * layer.a, layer.a) + acc * (1.0 - layer.a);
+}
+
+void main()
+{
+    vec4 acc = vec4(0.0);
+    acc = over(acc, faceLegsTorsoHat.x);
+    acc = over(acc, faceLegsTorsoHat.y);
+    acc = over(acc, faceLegsTorsoHat.z);
+    acc = over(acc, faceLegsTorsoHat.w);
+    acc = over(acc, hands);
+
+    // blending expects straight alpha
+    fragColor = acc.a > 0.0 ? vec4(acc.rgb / acc.a, acc.a * opacity) : vec4(0.0);
+}
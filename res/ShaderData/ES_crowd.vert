@@ -0,0 +1,30 @@
+#version 300 es
+precision mediump float;
+
+layout (location = 0) in vec2 corner;
+layout (location = 1) in vec4 rect;
+layout (location = 2) in vec4 layersA;
+layout (location = 3) in vec3 layersB;
+
+out vec2 texCoords;
+flat out vec4 faceLegsTorsoHat;
+flat out float hands;
+flat out float opacity;
+
+layout (std140) uniform FrameData
+{
+    mat4 projection;
+    vec2 resolution;
+    float time;
+};
+
+void main()
+{
+    // layersB is (hands, flip, opacity)
+    texCoords = vec2(layersB.y > 0.5 ? 1.0 - corner.x : corner.x, corner.y);
+    faceLegsTorsoHat = layersA;
+    hands = layersB.x;
+    opacity = layersB.z;
+
+    gl_Position = projection * vec4(rect.xy + corner * rect.zw, 0.0, 1.0);
+}
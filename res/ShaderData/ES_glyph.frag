@@ -1,12 +1,13 @@
+#version 300 es
 precision mediump float;
 
-varying vec2 texCoords;
+in vec2 texCoords;
+in vec4 vertexColor;
+out vec4 fragColor;
 
 uniform sampler2D glyph;
-uniform vec3 textColor;
 
 void main()
 {
-    vec4 sampled = vec4(1.0, 1.0, 1.0, texture2D(glyph, texCoords).a);
-    gl_FragColor = sampled * vec4(textColor, 1.0);
+    fragColor = vec4(vertexColor.rgb, vertexColor.a * texture(glyph, texCoords).a);
 }
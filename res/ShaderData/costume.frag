@@ -0,0 +1,13 @@
+#version 330 core
+in vec2 texCoords;
+in vec4 vertexColor;
+out vec4 color;
+
+uniform sampler2D image;
+
+void main()
+{
+    // costume cache cells are premultiplied, blending expects straight alpha
+    vec4 texel = texture(image, texCoords);
+    color = texel.a > 0.0 ? vec4(texel.rgb / texel.a, texel.a) * vertexColor : vec4(0.0);
+}
@@ -1,12 +1,11 @@
 #version 330 core
 in vec2 texCoords;
+in vec4 vertexColor;
 out vec4 color;
 
 uniform sampler2D glyph;
-uniform vec3 textColor;
 
 void main()
 {
-    vec4 sampled = vec4(1.0, 1.0, 1.0, texture(glyph, texCoords).r);
-    color = sampled * vec4(textColor, 1.0);
+    color = vec4(vertexColor.rgb, vertexColor.a * texture(glyph, texCoords).r);
 }
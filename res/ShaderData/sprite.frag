@@ -1,18 +1,11 @@
 #version 330 core
 in vec2 texCoords;
+in vec4 vertexColor;
 out vec4 color;
 
 uniform sampler2D image;
-uniform float opacity;
-uniform bool flip;
 
 void main()
 {
-    vec2 coords = texCoords;
-    if(flip)
-        coords.x = 1 - coords.x;
-
-    color = texture(image, coords);
-
-    color.a *= opacity;
+    color = texture(image, texCoords) * vertexColor;
 }
@@ -1,13 +1,21 @@
 #version 330 core
 layout (location = 0) in vec2 pos;
+layout (location = 1) in vec2 uv;
+layout (location = 2) in vec4 color;
 
 out vec2 texCoords;
+out vec4 vertexColor;
 
-uniform mat4 model;
-uniform mat4 projection;
+layout (std140) uniform FrameData
+{
+    mat4 projection;
+    vec2 resolution;
+    float time;
+};
 
 void main()
 {
-    texCoords = pos;
-    gl_Position = projection * model * vec4(pos, 0.0, 1.0);
-}
\ No newline at end of file
+    texCoords = uv;
+    vertexColor = color;
+    gl_Position = projection * vec4(pos, 0.0, 1.0);
+}
@@ -13,6 +13,18 @@
 constexpr auto FRICTION = 1.35f;
 
 
+// SIMULATION
+
+// the rate every per-tick speed (lerp factors, animation frame lengths) was tuned at
+constexpr auto BASE_TICK_RATE = 60;
+constexpr auto DEFAULT_TICK_RATE = 60;
+constexpr auto MIN_TICK_RATE = 10;
+constexpr auto MAX_TICK_RATE = 240;
+
+// never run more ticks than this in one frame, so a slow frame can't snowball into slower ones
+constexpr auto MAX_TICKS_PER_FRAME = 8;
+
+
 // CONTROLLER
 
 // joystick value under this means 0
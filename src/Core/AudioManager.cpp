@@ -1,5 +1,6 @@
 #include "AudioManager.h"
 
+#include "Outrospection.h"
 #include "Util.h"
 #include "Core/File.h"
 
@@ -26,17 +27,15 @@ void AudioManager::init(const std::vector<std::string>& sounds)
 
     LOG("Asychronously preloading sounds...");
     // load the unordered_map with the keys, then load asynchronously
+    JobSystem& jobSystem = Outrospection::get().jobSystem;
     for(const std::string& sound : sounds) {
         auto [it, success] = waves.try_emplace(sound);
 
         if(!it->second) {
             it->second = std::make_unique<SoLoud::Wav>();
 
-#ifdef PLATFORM_EMSCRIPTEN
-            loadSound(it->second.get(), sound); // Emscripten does not support std::async
-#else
-            m_futureWaves.push_back(std::async(std::launch::async, loadSound, it->second.get(), sound));
-#endif
+            SoLoud::Wav* wave = it->second.get();
+            m_waveLoads[sound] = jobSystem.schedule([wave, sound] { loadSound(wave, sound); });
         }
     }
 
@@ -45,6 +44,10 @@ void AudioManager::init(const std::vector<std::string>& sounds)
 
 AudioManager::~AudioManager()
 {
+    // don't pull the waves out from under sounds that are still loading
+    for (const auto& [sound, load] : m_waveLoads)
+        Outrospection::get().jobSystem.wait(load);
+
     engine.deinit();
 }
 
@@ -59,6 +62,13 @@ void AudioManager::play(const std::string& soundName, float vol, bool loop)
     auto& [key, wavePtr] = *waves.try_emplace(soundName).first;
     if (wavePtr)
     {
+        const auto load = m_waveLoads.find(soundName);
+        if (load != m_waveLoads.end())
+        {
+            Outrospection::get().jobSystem.wait(load->second);
+            m_waveLoads.erase(load);
+        }
+
         wave = &*wavePtr;
     }
     else
@@ -4,26 +4,21 @@
 #include <unordered_map>
 #include <memory>
 #include <list>
-#include <thread>
 #include <vector>
 
-#ifndef PLATFORM_EMSCRIPTEN
-#include <future>
-#endif
-
 #include <soloud.h>
 #include <soloud_wav.h>
 
 #include "Core.h"
+#include "Core/JobSystem.h"
 
 class AudioManager
 {
 private:
     SoLoud::Soloud engine;
 
-#ifndef PLATFORM_EMSCRIPTEN
-    std::vector<std::future<void>> m_futureWaves;
-#endif
+    // sounds decode on the job system, play() waits for the ones that aren't done yet
+    std::unordered_map<std::string, JobSystem::Handle> m_waveLoads;
 
     std::unordered_map<std::string, std::unique_ptr<SoLoud::Wav>> waves;
     std::unordered_map<std::string, SoLoud::handle> handles;
@@ -0,0 +1,103 @@
+#include "CostumeCatalog.h"
+
+#include "Util.h"
+
+void CostumeCatalog::load()
+{
+    // costumes point at parts by position, loading them again would append a second copy of each
+    if (m_loaded)
+    {
+        LOG_ERROR("The costume catalog is already loaded!");
+        return;
+    }
+
+    m_loaded = true;
+
+    add(HumanLayer::HAT, Resource());
+    add(HumanLayer::HAT, "hat/0");
+    add(HumanLayer::HAT, "hat/1");
+    add(HumanLayer::HAT, "hat/2", true);
+    add(HumanLayer::HAT, "hat/3");
+    add(HumanLayer::FACE, "face/0");
+    add(HumanLayer::FACE, "face/1");
+    add(HumanLayer::FACE, "face/2");
+    add(HumanLayer::FACE, "face/3", true);
+    add(HumanLayer::FACE, "face/4");
+    add(HumanLayer::TORSO, "torso/0");
+    add(HumanLayer::TORSO, "torso/1");
+    add(HumanLayer::TORSO, "torso/2", true);
+    add(HumanLayer::TORSO, "torso/3");
+    add(HumanLayer::TORSO, "torso/4");
+    add(HumanLayer::HANDS, Resource());
+    add(HumanLayer::HANDS, "hands/0");
+    add(HumanLayer::HANDS, "hands/1", true);
+    add(HumanLayer::HANDS, "hands/2");
+    add(HumanLayer::HANDS, "hands/3");
+    add(HumanLayer::LEGS, "legs/0");
+    add(HumanLayer::LEGS, "legs/1", true);
+    add(HumanLayer::LEGS, "legs/2");
+    add(HumanLayer::LEGS, "legs/3");
+    add(HumanLayer::LEGS, "legs/4");
+}
+
+size_t CostumeCatalog::partCount(int layer) const
+{
+    return m_parts[layer].size();
+}
+
+const Resource& CostumeCatalog::getPart(int layer, uint8_t part) const
+{
+    return m_parts[layer][part];
+}
+
+bool CostumeCatalog::isBad(int layer, uint8_t part) const
+{
+    return m_bad[layer][part];
+}
+
+bool CostumeCatalog::isBad(const Costume& costume) const
+{
+    for (int layer = 0; layer < LAYER_COUNT; layer++)
+    {
+        if (isBad(layer, costume.parts[layer]))
+            return true;
+    }
+
+    return false;
+}
+
+uint32_t CostumeCatalog::indexOf(const Costume& costume) const
+{
+    // one digit per layer, each in base partCount(layer)
+    uint32_t index = 0;
+    for (int layer = 0; layer < LAYER_COUNT; layer++)
+        index = index * uint32_t(partCount(layer)) + costume.parts[layer];
+
+    return index;
+}
+
+uint32_t CostumeCatalog::costumeCount() const
+{
+    uint32_t count = 1;
+    for (int layer = 0; layer < LAYER_COUNT; layer++)
+        count *= uint32_t(partCount(layer));
+
+    return count;
+}
+
+void CostumeCatalog::add(HumanLayer layer, const Resource& resource, bool bad)
+{
+    if (m_parts[int(layer)].size() > UINT8_MAX)
+    {
+        LOG_ERROR("Too many parts in costume layer %i!", int(layer));
+        return;
+    }
+
+    m_parts[int(layer)].push_back(resource);
+    m_bad[int(layer)].push_back(bad);
+}
+
+void CostumeCatalog::add(HumanLayer layer, const std::string& textureName, bool bad)
+{
+    add(layer, simpleTexture({"CostumeData/", textureName}, GL_LINEAR), bad);
+}
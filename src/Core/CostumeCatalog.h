@@ -0,0 +1,62 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Core.h"
+#include "Core/Resource.h"
+
+enum class HumanLayer
+{
+    FACE    = 0,
+    LEGS    = 1,
+    TORSO   = 2,
+    HAT     = 3,
+    HANDS   = 4,
+};
+
+// Every costume part a human can wear, loaded once and shared by the character maker, the crowd
+// and the costume cache. A costume itself is just one small index per layer into it, so humans
+// don't each carry their own copy of the layer textures.
+class CostumeCatalog
+{
+public:
+    static constexpr int LAYER_COUNT = 5;
+
+    // the part picked for every layer, drawn in layer order
+    struct Costume
+    {
+        std::array<uint8_t, LAYER_COUNT> parts = {};
+
+        bool operator==(const Costume& other) const { return parts == other.parts; }
+    };
+
+    CostumeCatalog() = default;
+
+    // registers every part and requests its texture, so it has to run once the texture manager is up.
+    // Only the first call does anything, everyone else should only ever see a const CostumeCatalog&
+    void load();
+
+    size_t partCount(int layer) const;
+    const Resource& getPart(int layer, uint8_t part) const;
+    bool isBad(int layer, uint8_t part) const;
+
+    // true if any part of it is bad
+    bool isBad(const Costume& costume) const;
+
+    // every possible costume gets a number below costumeCount(), for tables indexed by costume
+    uint32_t indexOf(const Costume& costume) const;
+    uint32_t costumeCount() const;
+
+    DISALLOW_COPY_AND_ASSIGN(CostumeCatalog);
+private:
+    void add(HumanLayer layer, const Resource& resource, bool bad = false);
+    void add(HumanLayer layer, const std::string& textureName, bool bad = false);
+
+    std::array<std::vector<Resource>, LAYER_COUNT> m_parts;
+    std::array<std::vector<bool>, LAYER_COUNT> m_bad;
+
+    bool m_loaded = false;
+};
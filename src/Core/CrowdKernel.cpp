@@ -0,0 +1,235 @@
+#include "CrowdKernel.h"
+
+#include <bitset>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define CROWD_KERNEL_X86
+
+#include <immintrin.h>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#define AVX2_TARGET
+#else
+// only this function is built for AVX2, the rest of the game still runs on any x86-64 CPU
+#define AVX2_TARGET __attribute__((target("avx2")))
+#endif
+#endif
+
+namespace
+{
+    // the reference every SIMD path has to match exactly, also used for the leftover tail
+    inline size_t integrateOne(const CrowdKernel::Crowd& crowd, size_t i, float lerpFactor, float arriveDistanceSq)
+    {
+        if (!crowd.moving[i])
+            return 0;
+
+        const float goalX = crowd.goalX[i];
+        const float goalY = crowd.goalY[i];
+
+        const float x = crowd.posX[i] + (goalX - crowd.posX[i]) * lerpFactor;
+        const float y = crowd.posY[i] + (goalY - crowd.posY[i]) * lerpFactor;
+
+        crowd.facingRight[i] = goalX > x;
+
+        const float dx = goalX - x;
+        const float dy = goalY - y;
+        if (dx * dx + dy * dy <= arriveDistanceSq)
+        {
+            crowd.posX[i] = goalX;
+            crowd.posY[i] = goalY;
+            crowd.moving[i] = 0;
+
+            return 1;
+        }
+
+        crowd.posX[i] = x;
+        crowd.posY[i] = y;
+
+        return 0;
+    }
+
+    size_t integrateScalar(const CrowdKernel::Crowd& crowd, size_t begin, float lerpFactor, float arriveDistanceSq)
+    {
+        size_t arrived = 0;
+        for (size_t i = begin; i < crowd.count; i++)
+            arrived += integrateOne(crowd, i, lerpFactor, arriveDistanceSq);
+
+        return arrived;
+    }
+
+#ifdef CROWD_KERNEL_X86
+    // write back the per-human flags of one block of lanes
+    inline size_t storeFlags(const CrowdKernel::Crowd& crowd, size_t i, int lanes, int activeBits, int arrivedBits, int rightBits)
+    {
+        for (int lane = 0; lane < lanes; lane++)
+        {
+            if (!(activeBits & (1 << lane)))
+                continue;
+
+            crowd.facingRight[i + lane] = (rightBits >> lane) & 1;
+            if (arrivedBits & (1 << lane))
+                crowd.moving[i + lane] = 0;
+        }
+
+        return std::bitset<8>(arrivedBits).count();
+    }
+
+    size_t integrateSse2(const CrowdKernel::Crowd& crowd, float lerpFactor, float arriveDistanceSq)
+    {
+        const __m128 factor = _mm_set1_ps(lerpFactor);
+        const __m128 arriveSq = _mm_set1_ps(arriveDistanceSq);
+        const __m128i zero = _mm_setzero_si128();
+
+        size_t arrived = 0;
+        size_t i = 0;
+        for (; i + 4 <= crowd.count; i += 4)
+        {
+            int32_t movingBytes;
+            std::memcpy(&movingBytes, crowd.moving + i, sizeof(movingBytes));
+            if (movingBytes == 0)
+                continue; // the whole block is standing still
+
+            const __m128i moving = _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(movingBytes), zero), zero);
+            const __m128 active = _mm_castsi128_ps(_mm_cmpgt_epi32(moving, zero));
+
+            const __m128 posX = _mm_loadu_ps(crowd.posX + i);
+            const __m128 posY = _mm_loadu_ps(crowd.posY + i);
+            const __m128 goalX = _mm_loadu_ps(crowd.goalX + i);
+            const __m128 goalY = _mm_loadu_ps(crowd.goalY + i);
+
+            const __m128 x = _mm_add_ps(posX, _mm_mul_ps(_mm_sub_ps(goalX, posX), factor));
+            const __m128 y = _mm_add_ps(posY, _mm_mul_ps(_mm_sub_ps(goalY, posY), factor));
+
+            const __m128 dx = _mm_sub_ps(goalX, x);
+            const __m128 dy = _mm_sub_ps(goalY, y);
+            const __m128 distSq = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+
+            const __m128 arrivedMask = _mm_and_ps(active, _mm_cmple_ps(distSq, arriveSq));
+            const __m128 rightMask = _mm_cmpgt_ps(goalX, x);
+
+            // arrived lanes snap to the goal, moving lanes take the new position, the rest stay put
+            const __m128 movedX = _mm_or_ps(_mm_and_ps(active, x), _mm_andnot_ps(active, posX));
+            const __m128 movedY = _mm_or_ps(_mm_and_ps(active, y), _mm_andnot_ps(active, posY));
+            _mm_storeu_ps(crowd.posX + i, _mm_or_ps(_mm_and_ps(arrivedMask, goalX), _mm_andnot_ps(arrivedMask, movedX)));
+            _mm_storeu_ps(crowd.posY + i, _mm_or_ps(_mm_and_ps(arrivedMask, goalY), _mm_andnot_ps(arrivedMask, movedY)));
+
+            arrived += storeFlags(crowd, i, 4, _mm_movemask_ps(active), _mm_movemask_ps(arrivedMask), _mm_movemask_ps(rightMask));
+        }
+
+        return arrived + integrateScalar(crowd, i, lerpFactor, arriveDistanceSq);
+    }
+
+    AVX2_TARGET size_t integrateAvx2(const CrowdKernel::Crowd& crowd, float lerpFactor, float arriveDistanceSq)
+    {
+        const __m256 factor = _mm256_set1_ps(lerpFactor);
+        const __m256 arriveSq = _mm256_set1_ps(arriveDistanceSq);
+        const __m256i zero = _mm256_setzero_si256();
+
+        size_t arrived = 0;
+        size_t i = 0;
+        for (; i + 8 <= crowd.count; i += 8)
+        {
+            int64_t movingBytes;
+            std::memcpy(&movingBytes, crowd.moving + i, sizeof(movingBytes));
+            if (movingBytes == 0)
+                continue; // the whole block is standing still
+
+            const __m256i moving = _mm256_cvtepu8_epi32(_mm_cvtsi64_si128(movingBytes));
+            const __m256 active = _mm256_castsi256_ps(_mm256_cmpgt_epi32(moving, zero));
+
+            const __m256 posX = _mm256_loadu_ps(crowd.posX + i);
+            const __m256 posY = _mm256_loadu_ps(crowd.posY + i);
+            const __m256 goalX = _mm256_loadu_ps(crowd.goalX + i);
+            const __m256 goalY = _mm256_loadu_ps(crowd.goalY + i);
+
+            const __m256 x = _mm256_add_ps(posX, _mm256_mul_ps(_mm256_sub_ps(goalX, posX), factor));
+            const __m256 y = _mm256_add_ps(posY, _mm256_mul_ps(_mm256_sub_ps(goalY, posY), factor));
+
+            const __m256 dx = _mm256_sub_ps(goalX, x);
+            const __m256 dy = _mm256_sub_ps(goalY, y);
+            const __m256 distSq = _mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy));
+
+            const __m256 arrivedMask = _mm256_and_ps(active, _mm256_cmp_ps(distSq, arriveSq, _CMP_LE_OQ));
+            const __m256 rightMask = _mm256_cmp_ps(goalX, x, _CMP_GT_OQ);
+
+            // arrived lanes snap to the goal, moving lanes take the new position, the rest stay put
+            const __m256 movedX = _mm256_blendv_ps(posX, x, active);
+            const __m256 movedY = _mm256_blendv_ps(posY, y, active);
+            _mm256_storeu_ps(crowd.posX + i, _mm256_blendv_ps(movedX, goalX, arrivedMask));
+            _mm256_storeu_ps(crowd.posY + i, _mm256_blendv_ps(movedY, goalY, arrivedMask));
+
+            arrived += storeFlags(crowd, i, 8, _mm256_movemask_ps(active), _mm256_movemask_ps(arrivedMask), _mm256_movemask_ps(rightMask));
+        }
+
+        return arrived + integrateScalar(crowd, i, lerpFactor, arriveDistanceSq);
+    }
+
+    bool cpuHasAvx2()
+    {
+#ifdef _MSC_VER
+        int info[4];
+        __cpuid(info, 1);
+
+        // the OS has to save the YMM registers too, not just the CPU support them
+        const bool osSavesYmm = (info[2] & (1 << 27)) && (info[2] & (1 << 28)) && (_xgetbv(0) & 6) == 6;
+        if (!osSavesYmm)
+            return false;
+
+        __cpuidex(info, 7, 0);
+        return (info[1] & (1 << 5)) != 0;
+#else
+        return __builtin_cpu_supports("avx2");
+#endif
+    }
+#endif
+}
+
+size_t CrowdKernel::integrate(const Crowd& crowd, float lerpFactor, float arriveDistance)
+{
+    return integrate(crowd, lerpFactor, arriveDistance, bestPath());
+}
+
+size_t CrowdKernel::integrate(const Crowd& crowd, float lerpFactor, float arriveDistance, Path path)
+{
+    const float arriveDistanceSq = arriveDistance * arriveDistance;
+
+    if (path == Path::AVX2 && bestPath() != Path::AVX2)
+        path = bestPath();
+
+    switch (path)
+    {
+#ifdef CROWD_KERNEL_X86
+    case Path::AVX2:
+        return integrateAvx2(crowd, lerpFactor, arriveDistanceSq);
+    case Path::SSE2:
+        return integrateSse2(crowd, lerpFactor, arriveDistanceSq);
+#endif
+    default:
+        return integrateScalar(crowd, 0, lerpFactor, arriveDistanceSq);
+    }
+}
+
+CrowdKernel::Path CrowdKernel::bestPath()
+{
+#ifdef CROWD_KERNEL_X86
+    static const Path best = cpuHasAvx2() ? Path::AVX2 : Path::SSE2;
+    return best;
+#else
+    return Path::SCALAR;
+#endif
+}
+
+const char* CrowdKernel::pathName(Path path)
+{
+    switch (path)
+    {
+    case Path::AVX2:
+        return "AVX2";
+    case Path::SSE2:
+        return "SSE2";
+    default:
+        return "scalar";
+    }
+}
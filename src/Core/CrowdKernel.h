@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Moves a whole crowd towards its goals in one pass over structure-of-arrays data, see CrowdStore.
+// Uses AVX2 or SSE2 when the CPU has them and falls back to plain scalar code everywhere else.
+namespace CrowdKernel
+{
+    struct Crowd
+    {
+        float* posX;
+        float* posY;
+        const float* goalX;
+        const float* goalY;
+
+        uint8_t* moving;      // non-zero for humans that should move, cleared once they arrive
+        uint8_t* facingRight; // updated for every human that moved
+        size_t count;
+    };
+
+    enum class Path
+    {
+        SCALAR,
+        SSE2,
+        AVX2,
+    };
+
+    // move every moving human lerpFactor of the way to its goal and snap it there once it's closer
+    // than arriveDistance. Returns how many humans arrived
+    size_t integrate(const Crowd& crowd, float lerpFactor, float arriveDistance);
+
+    // the same with a specific path, for benchmarks. Falls back to bestPath() if the CPU lacks it
+    size_t integrate(const Crowd& crowd, float lerpFactor, float arriveDistance, Path path);
+
+    Path bestPath();
+    const char* pathName(Path path);
+}
@@ -0,0 +1,338 @@
+#include "CrowdSlots.h"
+
+#include <cmath>
+
+#include "Core/CrowdKernel.h"
+
+namespace
+{
+    // closer than this, humans snap onto their goal and stop moving
+    constexpr float ARRIVE_DISTANCE = 0.05f;
+
+    // a bit smaller than a human, so a query only ever has to look at a few cells
+    constexpr float GRID_CELL_SIZE = 128;
+
+    bool isStanding(HumanState state)
+    {
+        return state == HumanState::ALIVE || state == HumanState::DOOMED;
+    }
+}
+
+const char* humanStateName(HumanState state)
+{
+    switch (state)
+    {
+    case HumanState::ALIVE:
+        return "alive";
+    case HumanState::DOOMED:
+        return "doomed";
+    case HumanState::EXPLODING:
+        return "exploding";
+    case HumanState::DEAD:
+        return "dead";
+    }
+
+    return "unknown";
+}
+
+CrowdSlots::CrowdSlots(glm::vec2 spriteSize) : m_spriteSize(spriteSize), m_grid(GRID_CELL_SIZE)
+{
+}
+
+uint32_t CrowdSlots::spawn(glm::vec2 pos, glm::vec2 goal, const Costume& costume, bool bad)
+{
+    // goes last, so it's drawn on top of everyone already there
+    const HandlePool::Allocation allocation = m_pool.allocate();
+    resizeSlots(m_pool.slotCount());
+
+    const uint32_t index = allocation.slot;
+
+    m_posX[index] = m_prevX[index] = pos.x;
+    m_posY[index] = m_prevY[index] = pos.y;
+    m_goalX[index] = goal.x;
+    m_goalY[index] = goal.y;
+    m_facingRight[index] = goal.x > pos.x;
+    m_bad[index] = bad;
+    m_state[index] = HumanState::ALIVE;
+    m_costume[index] = costume;
+    m_deadline[index] = NEVER;
+
+    updateMoving(index);
+    m_grid.insert(index, spriteCenter(pos.x, pos.y));
+
+    m_population.alive++;
+    if (bad)
+        m_population.bad++;
+
+    if (m_populationChanged)
+        m_populationChanged(m_population);
+
+    return allocation.handle;
+}
+
+bool CrowdSlots::contains(uint32_t id) const
+{
+    return m_pool.contains(id);
+}
+
+uint32_t CrowdSlots::slotOf(uint32_t id) const
+{
+    return m_pool.slotOf(id);
+}
+
+uint32_t CrowdSlots::idAt(uint32_t slot) const
+{
+    return m_pool.handleAt(slot);
+}
+
+size_t CrowdSlots::size() const
+{
+    return m_pool.size();
+}
+
+size_t CrowdSlots::slotCount() const
+{
+    return m_pool.slotCount();
+}
+
+const CrowdSlots::Population& CrowdSlots::population() const
+{
+    return m_population;
+}
+
+void CrowdSlots::onPopulationChanged(PopulationCallback callback)
+{
+    m_populationChanged = std::move(callback);
+}
+
+glm::vec2 CrowdSlots::getPos(uint32_t slot) const
+{
+    return { m_posX[slot], m_posY[slot] };
+}
+
+glm::vec2 CrowdSlots::getGoal(uint32_t slot) const
+{
+    return { m_goalX[slot], m_goalY[slot] };
+}
+
+void CrowdSlots::setGoal(uint32_t slot, glm::vec2 goal)
+{
+    m_goalX[slot] = goal.x;
+    m_goalY[slot] = goal.y;
+
+    updateMoving(slot);
+}
+
+bool CrowdSlots::hasGoal(uint32_t slot) const
+{
+    // the same test as UIComponent::hasGoal
+    return (1 - std::abs(glm::dot(getGoal(slot), getPos(slot)))) > 0.1;
+}
+
+void CrowdSlots::warpToGoal(uint32_t slot)
+{
+    const glm::vec2 goal = getGoal(slot);
+    if (glm::length(goal) > 0)
+    {
+        m_posX[slot] = m_prevX[slot] = goal.x;
+        m_posY[slot] = m_prevY[slot] = goal.y;
+        m_moving[slot] = 0;
+
+        m_grid.move(slot, spriteCenter(goal.x, goal.y));
+    }
+}
+
+HumanState CrowdSlots::getState(uint32_t slot) const
+{
+    return m_state[slot];
+}
+
+bool CrowdSlots::isDead(uint32_t slot) const
+{
+    return !isStanding(m_state[slot]);
+}
+
+bool CrowdSlots::isBad(uint32_t slot) const
+{
+    return m_bad[slot];
+}
+
+void CrowdSlots::doom(uint32_t slot, time_t now)
+{
+    if (isDead(slot))
+        return;
+
+    setState(slot, HumanState::DOOMED);
+    m_deadline[slot] = now + DELETION_DELAY;
+}
+
+void CrowdSlots::startExploding(uint32_t slot, time_t now)
+{
+    setState(slot, HumanState::EXPLODING);
+    m_deadline[slot] = now + OBLITERATION_DELAY;
+    m_moving[slot] = 0;
+    m_grid.remove(slot);
+}
+
+void CrowdSlots::beginTick()
+{
+    m_prevX = m_posX;
+    m_prevY = m_posY;
+}
+
+void CrowdSlots::move(float lerpFactor)
+{
+    const CrowdKernel::Crowd crowd = { m_posX.data(), m_posY.data(), m_goalX.data(), m_goalY.data(),
+                                       m_moving.data(), m_facingRight.data(), slotCount() };
+
+    CrowdKernel::integrate(crowd, lerpFactor, ARRIVE_DISTANCE);
+
+    // only humans that actually moved this tick need to be re-filed, and most of them stay in their cell
+    const size_t count = slotCount();
+    for (uint32_t i = 0; i < count; i++)
+    {
+        if (m_posX[i] != m_prevX[i] || m_posY[i] != m_prevY[i])
+            m_grid.move(i, spriteCenter(m_posX[i], m_posY[i]));
+    }
+}
+
+void CrowdSlots::compact()
+{
+    const uint32_t count = m_pool.compact([this](uint32_t from, uint32_t to) {
+        moveSlot(from, to);
+    });
+
+    resizeSlots(count);
+}
+
+void CrowdSlots::queryRadius(glm::vec2 center, float radius, std::vector<uint32_t>& out) const
+{
+    const size_t first = out.size();
+    m_grid.queryRadius(center, radius, out);
+
+    // the grid knows slots, callers want ids
+    for (size_t i = first; i < out.size(); i++)
+        out[i] = m_pool.handleAt(out[i]);
+}
+
+void CrowdSlots::queryRect(glm::vec2 min, glm::vec2 max, std::vector<uint32_t>& out) const
+{
+    const size_t first = out.size();
+    m_grid.queryRect(min, max, out);
+
+    for (size_t i = first; i < out.size(); i++)
+        out[i] = m_pool.handleAt(out[i]);
+}
+
+uint32_t CrowdSlots::nearest(glm::vec2 pos, float maxDistance) const
+{
+    const uint32_t slot = m_grid.nearest(pos, maxDistance);
+    return slot == SpatialGrid::NONE ? NONE : m_pool.handleAt(slot);
+}
+
+uint32_t CrowdSlots::humanAt(glm::vec2 point) const
+{
+    // a sprite covers point exactly when its center is within half a sprite of it
+    m_queryResults.clear();
+    m_grid.queryRect(point - m_spriteSize / 2.0f, point + m_spriteSize / 2.0f, m_queryResults);
+
+    // humans in later slots are drawn over earlier ones
+    uint32_t top = SpatialGrid::NONE;
+    for (const uint32_t slot : m_queryResults)
+    {
+        if (top == SpatialGrid::NONE || slot > top)
+            top = slot;
+    }
+
+    return top == SpatialGrid::NONE ? NONE : m_pool.handleAt(top);
+}
+
+glm::vec2 CrowdSlots::spriteCenter(float x, float y) const
+{
+    return glm::vec2(x, y) + m_spriteSize / 2.0f;
+}
+
+void CrowdSlots::updateMoving(uint32_t index)
+{
+    // humans without a goal or on their way out stay where they are
+    const bool hasGoal = m_goalX[index] != 0 || m_goalY[index] != 0;
+    const bool there = m_posX[index] == m_goalX[index] && m_posY[index] == m_goalY[index];
+
+    m_moving[index] = isStanding(m_state[index]) && hasGoal && !there;
+}
+
+void CrowdSlots::kill(uint32_t index)
+{
+    setState(index, HumanState::DEAD);
+    m_deadline[index] = NEVER;
+
+    // nothing left to draw, the slot goes away with the next compaction
+    m_pool.release(m_pool.handleAt(index));
+}
+
+void CrowdSlots::resizeSlots(size_t count)
+{
+    m_posX.resize(count);
+    m_posY.resize(count);
+    m_prevX.resize(count);
+    m_prevY.resize(count);
+    m_goalX.resize(count);
+    m_goalY.resize(count);
+    m_moving.resize(count, 0);
+    m_facingRight.resize(count, 0);
+    m_bad.resize(count, 0);
+    m_state.resize(count, HumanState::DEAD);
+    m_costume.resize(count);
+    m_deadline.resize(count, NEVER);
+}
+
+void CrowdSlots::moveSlot(uint32_t from, uint32_t to)
+{
+    m_posX[to] = m_posX[from];
+    m_posY[to] = m_posY[from];
+    m_prevX[to] = m_prevX[from];
+    m_prevY[to] = m_prevY[from];
+    m_goalX[to] = m_goalX[from];
+    m_goalY[to] = m_goalY[from];
+    m_moving[to] = m_moving[from];
+    m_facingRight[to] = m_facingRight[from];
+    m_bad[to] = m_bad[from];
+    m_state[to] = m_state[from];
+    m_costume[to] = m_costume[from];
+    m_deadline[to] = m_deadline[from];
+
+    // the slot it moves into is free, so it's not in the grid
+    if (m_grid.contains(from))
+    {
+        m_grid.remove(from);
+        m_grid.insert(to, spriteCenter(m_posX[to], m_posY[to]));
+    }
+}
+
+void CrowdSlots::setState(uint32_t index, HumanState state)
+{
+    const bool wasStanding = isStanding(m_state[index]);
+    m_state[index] = state;
+
+    // doomed and exploding humans change state without changing the numbers
+    if (wasStanding == isStanding(state))
+        return;
+
+    if (wasStanding)
+    {
+        m_population.alive--;
+        m_population.dead++;
+        if (m_bad[index])
+            m_population.bad--;
+    }
+    else
+    {
+        m_population.alive++;
+        m_population.dead--;
+        if (m_bad[index])
+            m_population.bad++;
+    }
+
+    if (m_populationChanged)
+        m_populationChanged(m_population);
+}
@@ -0,0 +1,183 @@
+#pragma once
+
+#include <cstdint>
+#include <ctime>
+#include <limits>
+#include <vector>
+
+#include <glm.hpp>
+
+#include "Core.h"
+#include "Core/CostumeCatalog.h"
+#include "Core/HandlePool.h"
+#include "Core/SmallFunction.h"
+#include "Core/SpatialGrid.h"
+
+enum class HumanState : uint8_t
+{
+    ALIVE,
+    DOOMED,     // marked for deletion, explodes once its deadline passes
+    EXPLODING,  // dies once its deadline passes
+    DEAD,
+};
+
+// lower case, for logs
+const char* humanStateName(HumanState state);
+
+// The storage and life cycle half of CrowdStore: one array per field instead of one object per
+// human, the ids, deadlines, population counts and the spatial grid. None of it needs the rest of
+// the engine, so tools can run it as is, see tools/CrowdSoak.
+// New humans always go at the end, so slot order is drawing order, and the slots of dead ones get
+// compacted away once enough of them pile up, so memory and the per-tick loops follow the living
+// population rather than everyone that ever lived.
+class CrowdSlots
+{
+public:
+    using Costume = CostumeCatalog::Costume;
+
+    static constexpr time_t NEVER = std::numeric_limits<time_t>::max();
+    static constexpr uint32_t NONE = HandlePool::NONE;
+
+    // how long a doomed human has left, and how long its explosion lasts, in ms
+    static constexpr time_t DELETION_DELAY = 2000;
+    static constexpr time_t OBLITERATION_DELAY = 300;
+
+    // kept up to date on every state change, so reading it never walks the crowd
+    struct Population
+    {
+        uint32_t alive = 0; // still standing, doomed ones included
+        uint32_t dead = 0;  // exploding or gone
+        uint32_t bad = 0;   // standing and wearing something bad
+    };
+
+    using PopulationCallback = SmallFunction<void(const Population&), 32>;
+
+    // positions are the top left of a human's sprite, the grid files them by its center
+    explicit CrowdSlots(glm::vec2 spriteSize);
+
+    // returns the id of the new human
+    uint32_t spawn(glm::vec2 pos, glm::vec2 goal, const Costume& costume, bool bad);
+
+    // false once the human is dead and gone
+    bool contains(uint32_t id) const;
+    // NONE for ids contains() is false for
+    uint32_t slotOf(uint32_t id) const;
+    uint32_t idAt(uint32_t slot) const;
+
+    // humans that aren't dead yet, exploding ones included
+    size_t size() const;
+    // slots in use or waiting for the next compaction
+    size_t slotCount() const;
+
+    // calls visit(slot) for every human that isn't dead yet, in drawing order
+    template<typename Visitor>
+    void forEachSlot(Visitor&& visit) const
+    {
+        const uint32_t slots = m_pool.slotCount();
+        for (uint32_t slot = 0; slot < slots; slot++)
+        {
+            if (m_pool.handleAt(slot) != NONE)
+                visit(slot);
+        }
+    }
+
+    const Population& population() const;
+    // called with the new numbers whenever a human is spawned or dies
+    void onPopulationChanged(PopulationCallback callback);
+
+    // per human, by slot
+    glm::vec2 getPos(uint32_t slot) const;
+    glm::vec2 getGoal(uint32_t slot) const;
+    void setGoal(uint32_t slot, glm::vec2 goal);
+    bool hasGoal(uint32_t slot) const;
+    void warpToGoal(uint32_t slot);
+
+    HumanState getState(uint32_t slot) const;
+    bool isDead(uint32_t slot) const;
+    bool isBad(uint32_t slot) const;
+
+    // explodes DELETION_DELAY after now, unless it's dead already
+    void doom(uint32_t slot, time_t now);
+    // stops it and takes it out of the grid, it dies OBLITERATION_DELAY after now
+    void startExploding(uint32_t slot, time_t now);
+
+    // remember where everyone was, drawing interpolates from there. Call at the start of every tick
+    void beginTick();
+
+    // move everyone that's still standing towards their goal, all in one CrowdKernel pass
+    void move(float lerpFactor);
+
+    // kill exploding humans once their deadline passed, and call explode(slot) for doomed ones whose
+    // deadline passed, which has to startExploding() them. Compacts once enough slots are free
+    template<typename Exploder>
+    void expireDeadlines(time_t now, Exploder&& explode)
+    {
+        const size_t count = slotCount();
+        for (uint32_t i = 0; i < count; i++)
+        {
+            if (m_deadline[i] > now)
+                continue;
+
+            if (m_state[i] == HumanState::DOOMED)
+                explode(i);
+            else
+                kill(i);
+        }
+
+        if (m_pool.wantsCompaction())
+            compact();
+    }
+
+    // squeeze out the slots of dead humans, keeping everyone's drawing order. Ids stay valid
+    void compact();
+
+    // spatial queries over the humans that are still standing, by the center of their sprite.
+    // These append ids to out
+    void queryRadius(glm::vec2 center, float radius, std::vector<uint32_t>& out) const;
+    void queryRect(glm::vec2 min, glm::vec2 max, std::vector<uint32_t>& out) const;
+    uint32_t nearest(glm::vec2 pos, float maxDistance) const;
+
+    // the id of the standing human whose sprite covers point, or NONE.
+    // Where sprites overlap, the one drawn on top wins
+    uint32_t humanAt(glm::vec2 point) const;
+
+    DISALLOW_COPY_AND_ASSIGN(CrowdSlots);
+protected:
+    // which slots hold a human, and which id belongs to which slot
+    HandlePool m_pool;
+
+    // per slot
+    std::vector<float> m_posX, m_posY;
+    std::vector<float> m_prevX, m_prevY; // position before the latest tick
+    std::vector<float> m_goalX, m_goalY;
+    std::vector<uint8_t> m_moving;      // still on the way to a goal, see CrowdKernel
+    std::vector<uint8_t> m_facingRight;
+    std::vector<uint8_t> m_bad;
+    std::vector<HumanState> m_state;
+    std::vector<Costume> m_costume;
+    std::vector<time_t> m_deadline;
+
+private:
+    glm::vec2 spriteCenter(float x, float y) const;
+
+    void updateMoving(uint32_t index);
+
+    // the deadline of an exploding human passed, it's gone
+    void kill(uint32_t index);
+
+    // make every per-human array count slots long
+    void resizeSlots(size_t count);
+    void moveSlot(uint32_t from, uint32_t to);
+
+    // every state change goes through here to keep m_population right
+    void setState(uint32_t index, HumanState state);
+
+    glm::vec2 m_spriteSize;
+
+    Population m_population;
+    PopulationCallback m_populationChanged;
+
+    // standing humans by slot and the center of their sprite, updated whenever one moves
+    SpatialGrid m_grid;
+    mutable std::vector<uint32_t> m_queryResults;
+};
@@ -0,0 +1,161 @@
+#include "Cutscene.h"
+
+#include <algorithm>
+#include <exception>
+
+#include "Core/UI/UIComponent.h"
+
+Cutscene Cutscene::promise_type::get_return_object()
+{
+    return Cutscene(Handle::from_promise(*this));
+}
+
+void Cutscene::promise_type::unhandled_exception()
+{
+    LOG_ERROR("Exception thrown inside a cutscene!");
+    std::terminate();
+}
+
+bool Cutscene::promise_type::ready()
+{
+    switch (waiting)
+    {
+    case Waiting::NOTHING:
+        return true;
+
+    case Waiting::TIME:
+        if (!skipping && time < deadline)
+            return false;
+
+        // the next wait counts from when this one was due, not from when the tick noticed
+        time = std::max(time, deadline);
+        cursor = deadline;
+        return true;
+
+    case Waiting::CONDITION:
+        if (!skipping && !condition())
+            return false;
+
+        cursor = time;
+        return true;
+    }
+
+    return true;
+}
+
+void Cutscene::WaitAwaiter::await_suspend(Handle handle) const
+{
+    promise_type& promise = handle.promise();
+
+    promise.waiting = promise_type::Waiting::TIME;
+    promise.deadline = promise.cursor + ms;
+}
+
+void Cutscene::UntilAwaiter::await_suspend(Handle handle)
+{
+    promise_type& promise = handle.promise();
+
+    promise.waiting = promise_type::Waiting::CONDITION;
+    promise.condition = std::move(condition);
+}
+
+Cutscene::WaitAwaiter Cutscene::wait(float ms)
+{
+    return { ms };
+}
+
+Cutscene::UntilAwaiter Cutscene::until(Condition predicate)
+{
+    return { std::move(predicate) };
+}
+
+Cutscene::UntilAwaiter Cutscene::animationDone(const UIComponent& component)
+{
+    return until([&component]() { return component.animationDone(); });
+}
+
+Cutscene::Cutscene(Handle handle) : m_handle(handle)
+{
+}
+
+Cutscene::Cutscene(Cutscene&& other) noexcept : m_handle(other.m_handle), m_speed(other.m_speed)
+{
+    other.m_handle = nullptr;
+}
+
+Cutscene& Cutscene::operator=(Cutscene&& other) noexcept
+{
+    if (this != &other)
+    {
+        if (m_handle)
+            m_handle.destroy();
+
+        m_handle = other.m_handle;
+        m_speed = other.m_speed;
+        other.m_handle = nullptr;
+    }
+
+    return *this;
+}
+
+Cutscene::~Cutscene()
+{
+    if (m_handle)
+        m_handle.destroy();
+}
+
+void Cutscene::tick(float deltaMs)
+{
+    if (!running())
+        return;
+
+    m_handle.promise().time += deltaMs * m_speed;
+    resumeWhileReady();
+}
+
+void Cutscene::fastForward(float ms)
+{
+    if (!running())
+        return;
+
+    m_handle.promise().time += ms;
+    resumeWhileReady();
+}
+
+void Cutscene::skip()
+{
+    if (!running())
+        return;
+
+    promise_type& promise = m_handle.promise();
+
+    promise.skipping = true;
+    resumeWhileReady();
+    promise.skipping = false;
+}
+
+void Cutscene::setSpeed(float speed)
+{
+    m_speed = speed;
+}
+
+bool Cutscene::running() const
+{
+    return m_handle && !m_handle.done();
+}
+
+void Cutscene::resumeWhileReady()
+{
+    // the script may start other cutscenes and move this object around, so only touch the frame
+    const Handle handle = m_handle;
+    promise_type& promise = handle.promise();
+
+    // several short waits can all be over within one tick
+    while (!handle.done() && promise.ready())
+    {
+        promise.waiting = promise_type::Waiting::NOTHING;
+        promise.condition.reset();
+
+        handle.resume();
+    }
+}
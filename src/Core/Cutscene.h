@@ -0,0 +1,111 @@
+#pragma once
+
+#include <coroutine>
+
+#include "Core.h"
+#include "SmallFunction.h"
+
+class UIComponent;
+
+// A scripted sequence written as one coroutine:
+//
+//     Cutscene GUIThing::playIntro()
+//     {
+//         m_title.opacityGoal = 1;
+//         co_await Cutscene::wait(2000);
+//         m_title.setAnimation("wave");
+//         co_await Cutscene::animationDone(m_title);
+//     }
+//
+// Hand it to Outrospection::playCutscene to have it ticked with the simulation. Waits are measured
+// on the cutscene's own clock from when the previous wait was due, so a script runs the same no matter
+// how the ticks fall, and fastForward()/skip() get through it deterministically.
+// Waiting allocates nothing, only the coroutine frame itself is allocated when the cutscene starts.
+class Cutscene
+{
+public:
+    using Condition = SmallFunction<bool(), 32>;
+
+    struct promise_type
+    {
+        Cutscene get_return_object();
+
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception();
+
+        // true once whatever the script is waiting on has happened
+        bool ready();
+
+        enum class Waiting
+        {
+            NOTHING,
+            TIME,
+            CONDITION,
+        } waiting = Waiting::NOTHING;
+
+        float time = 0;     // ms the cutscene has been running for
+        float cursor = 0;   // when the script's last step was due, waits count from here
+        float deadline = 0;
+        Condition condition;
+
+        bool skipping = false;
+    };
+
+    using Handle = std::coroutine_handle<promise_type>;
+
+    struct WaitAwaiter
+    {
+        float ms;
+
+        bool await_ready() const { return false; }
+        void await_suspend(Handle handle) const;
+        void await_resume() const {}
+    };
+
+    struct UntilAwaiter
+    {
+        Condition condition;
+
+        bool await_ready() const { return false; }
+        void await_suspend(Handle handle);
+        void await_resume() const {}
+    };
+
+    // resume ms after the previous step
+    static WaitAwaiter wait(float ms);
+    // resume on the first tick the predicate returns true
+    static UntilAwaiter until(Condition predicate);
+    // resume once the component's current animation played through. Looping animations never finish
+    static UntilAwaiter animationDone(const UIComponent& component);
+
+    Cutscene() = default;
+    Cutscene(Cutscene&& other) noexcept;
+    Cutscene& operator=(Cutscene&& other) noexcept;
+    ~Cutscene();
+
+    // advance the cutscene clock and run the script up to its next wait that isn't over yet
+    void tick(float deltaMs);
+
+    // jump ahead by ms of cutscene time, as if that much time passed in one tick
+    void fastForward(float ms);
+
+    // run the rest of the script right away, treating every wait as over
+    void skip();
+
+    // scales how fast the cutscene clock runs
+    void setSpeed(float speed);
+
+    bool running() const;
+
+    Cutscene(const Cutscene&) = delete;
+    Cutscene& operator=(const Cutscene&) = delete;
+private:
+    explicit Cutscene(Handle handle);
+
+    void resumeWhileReady();
+
+    Handle m_handle;
+    float m_speed = 1;
+};
@@ -0,0 +1,144 @@
+#include "FramePacer.h"
+
+#include <algorithm>
+#include <thread>
+
+namespace
+{
+    float toMs(FramePacer::Clock::duration duration)
+    {
+        return std::chrono::duration<float, std::milli>(duration).count();
+    }
+}
+
+FramePacer::FramePacer(int targetRate)
+{
+    setTargetRate(targetRate);
+}
+
+void FramePacer::setTargetRate(int framesPerSecond)
+{
+    m_targetRate = std::max(framesPerSecond, int(UNCAPPED));
+
+    if (m_targetRate == UNCAPPED)
+        m_period = Clock::duration::zero();
+    else
+        m_period = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / m_targetRate));
+
+    reset();
+}
+
+int FramePacer::getTargetRate() const
+{
+    return m_targetRate;
+}
+
+void FramePacer::setSwapInterval(int interval, int refreshRate)
+{
+    m_swapInterval = interval;
+    m_refreshRate = refreshRate;
+
+    reset();
+}
+
+void FramePacer::reset()
+{
+    m_lastFrame = Clock::now();
+    m_deadline = m_lastFrame + m_period;
+}
+
+void FramePacer::wait()
+{
+    Clock::time_point now = Clock::now();
+
+    if (waitsForDeadline())
+    {
+        if (now > m_deadline)
+        {
+            m_stats.missedDeadlines++;
+
+            // more than a whole frame late, start over instead of rushing the next frames to catch up
+            if (now - m_deadline > m_period)
+                m_deadline = now;
+        }
+        else
+        {
+            // sleep until shortly before the deadline...
+            const Clock::time_point wakeUp = m_deadline - m_sleepOvershoot;
+            if (now < wakeUp)
+            {
+                std::this_thread::sleep_for(wakeUp - now);
+                now = Clock::now();
+
+                // learn how late sleeps wake up. Jump up to a worse overshoot straight away, but
+                // only slowly trust better ones, so one lucky sleep doesn't make us miss deadlines
+                const Clock::duration overshoot = std::max(now - wakeUp, Clock::duration::zero());
+                if (overshoot > m_sleepOvershoot)
+                    m_sleepOvershoot = overshoot;
+                else
+                    m_sleepOvershoot = (m_sleepOvershoot * 15 + overshoot) / 16;
+
+                m_sleepOvershoot = std::clamp<Clock::duration>(m_sleepOvershoot, std::chrono::microseconds(100),
+                                                               std::chrono::milliseconds(4));
+            }
+
+            // ...and spin the rest of the way
+            const Clock::time_point spinStart = now;
+            while (now < m_deadline)
+            {
+                std::this_thread::yield();
+                now = Clock::now();
+            }
+
+            m_stats.spinMs += toMs(now - spinStart);
+        }
+
+        m_deadline += m_period;
+    }
+    else if (m_swapInterval > 0 && m_refreshRate > 0)
+    {
+        // paced by vsync, a frame that took a refresh and a half or more missed its swap
+        const auto refreshPeriod = std::chrono::duration<double>(double(m_swapInterval) / m_refreshRate);
+        if (now - m_lastFrame > refreshPeriod * 1.5)
+            m_stats.missedDeadlines++;
+    }
+
+    recordFrame(now);
+}
+
+FramePacer::Stats FramePacer::getStats() const
+{
+    Stats stats = m_stats;
+    if (stats.frames > 0)
+        stats.averageFrameMs = toMs(m_totalFrameTime) / float(stats.frames);
+
+    return stats;
+}
+
+void FramePacer::resetStats()
+{
+    m_stats = Stats();
+    m_totalFrameTime = Clock::duration::zero();
+}
+
+bool FramePacer::waitsForDeadline() const
+{
+    if (m_targetRate == UNCAPPED)
+        return false;
+
+    // vsync alone would run faster than the target, so we still have to hold frames back
+    if (m_swapInterval > 0 && m_refreshRate > 0)
+        return m_refreshRate > m_targetRate * m_swapInterval;
+
+    return true;
+}
+
+void FramePacer::recordFrame(Clock::time_point now)
+{
+    const Clock::duration frameTime = now - m_lastFrame;
+    m_lastFrame = now;
+
+    m_stats.frames++;
+    m_stats.worstFrameMs = std::max(m_stats.worstFrameMs, toMs(frameTime));
+    m_totalFrameTime += frameTime;
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <chrono>
+
+#include "Core.h"
+
+// Keeps frames evenly spaced at a target rate.
+// Sleeping alone overshoots by a millisecond or more, so the pacer sleeps until shortly before the
+// deadline and spins the rest of the way. How long it stops short adapts to how much sleeps actually
+// overshoot on this machine, so the spin stays short and doesn't burn a whole core.
+class FramePacer
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr int UNCAPPED = 0;
+
+    explicit FramePacer(int targetRate = 60);
+
+    // frames per second to aim for, UNCAPPED to never wait
+    void setTargetRate(int framesPerSecond);
+    int getTargetRate() const;
+
+    // with vsync on, presenting already blocks until the next refresh. If that is at least as slow as
+    // the target, waiting on top of it would only make us miss refreshes, so the pacer just measures
+    void setSwapInterval(int interval, int refreshRate);
+
+    // restart the schedule from now, e.g. after loading or being paused for a while
+    void reset();
+
+    // block until the next frame is due. Call once per frame, after presenting
+    void wait();
+
+    struct Stats
+    {
+        unsigned int frames = 0;
+        unsigned int missedDeadlines = 0;
+
+        float averageFrameMs = 0;
+        float worstFrameMs = 0;
+        float spinMs = 0; // total time spent busy-waiting
+    };
+
+    // counters since the last resetStats()
+    Stats getStats() const;
+    void resetStats();
+
+    DISALLOW_COPY_AND_ASSIGN(FramePacer);
+private:
+    bool waitsForDeadline() const;
+    void recordFrame(Clock::time_point now);
+
+    int m_targetRate = 60;
+    Clock::duration m_period;
+
+    int m_swapInterval = 0;
+    int m_refreshRate = 0;
+
+    Clock::time_point m_deadline;
+    Clock::time_point m_lastFrame;
+
+    // how much a sleep tends to overshoot, stop sleeping this early and spin instead
+    Clock::duration m_sleepOvershoot = std::chrono::milliseconds(1);
+
+    Stats m_stats;
+    Clock::duration m_totalFrameTime = Clock::duration::zero();
+};
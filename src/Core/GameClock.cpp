@@ -0,0 +1,132 @@
+#include "GameClock.h"
+
+#include <algorithm>
+#include <chrono>
+
+GameClock::GameClock()
+{
+    m_lastSample = m_source();
+}
+
+void GameClock::beginFrame()
+{
+    const Micros sample = m_source();
+
+    // a source going backwards would make everything run in reverse
+    m_realDelta = std::max(sample - m_lastSample, Micros(0));
+    m_lastSample = sample;
+    m_realNow += m_realDelta;
+
+    if (m_paused)
+    {
+        m_delta = 0;
+    }
+    else
+    {
+        const double scaled = double(m_realDelta) * m_scale + m_scaleRemainder;
+        m_delta = Micros(scaled);
+        m_scaleRemainder = scaled - double(m_delta);
+    }
+
+    m_delta += m_pendingAdvance;
+    m_pendingAdvance = 0;
+
+    m_now += m_delta;
+}
+
+GameClock::Micros GameClock::now() const
+{
+    return m_now;
+}
+
+time_t GameClock::nowMillis() const
+{
+    return time_t(m_now / 1000);
+}
+
+GameClock::Micros GameClock::frameDelta() const
+{
+    return m_delta;
+}
+
+float GameClock::deltaSeconds() const
+{
+    return float(m_delta) / 1000000.0f;
+}
+
+GameClock::Micros GameClock::realFrameDelta() const
+{
+    return m_realDelta;
+}
+
+float GameClock::realDeltaSeconds() const
+{
+    return float(m_realDelta) / 1000000.0f;
+}
+
+GameClock::Micros GameClock::realNow() const
+{
+    return m_realNow;
+}
+
+time_t GameClock::realNowMillis() const
+{
+    return time_t(m_realNow / 1000);
+}
+
+void GameClock::beginTick(float stepSeconds)
+{
+    m_tickNow += double(stepSeconds) * 1000000.0;
+}
+
+GameClock::Micros GameClock::tickNow() const
+{
+    return Micros(m_tickNow);
+}
+
+time_t GameClock::tickNowMillis() const
+{
+    return time_t(tickNow() / 1000);
+}
+
+void GameClock::setPaused(bool paused)
+{
+    m_paused = paused;
+}
+
+bool GameClock::isPaused() const
+{
+    return m_paused;
+}
+
+void GameClock::setScale(float scale)
+{
+    m_scale = std::max(scale, 0.0f);
+}
+
+float GameClock::getScale() const
+{
+    return m_scale;
+}
+
+void GameClock::advance(Micros amount)
+{
+    m_pendingAdvance += std::max(amount, Micros(0));
+}
+
+void GameClock::setSource(Source source)
+{
+    m_source = source ? std::move(source) : Source(steadyMicros);
+    resync();
+}
+
+void GameClock::resync()
+{
+    m_lastSample = m_source();
+}
+
+GameClock::Micros GameClock::steadyMicros()
+{
+    const auto now = std::chrono::steady_clock::now().time_since_epoch();
+    return std::chrono::duration_cast<std::chrono::microseconds>(now).count();
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <cstdint>
+#include <ctime>
+#include <functional>
+
+#include "Core.h"
+
+// The game's notion of time, sampled once at the start of every frame.
+// Everything that reads the time during a frame gets the same value, without touching the system clock.
+// Game time can be paused and scaled, and the underlying clock can be swapped out, e.g. to drive the
+// game from a test at a fixed rate.
+class GameClock
+{
+public:
+    using Micros = int64_t;
+    using Source = std::function<Micros()>;
+
+    GameClock();
+
+    // sample the source. Call once at the very start of a frame
+    void beginFrame();
+
+    // game time since the clock was created. Stops while paused, runs faster or slower when scaled
+    Micros now() const;
+    time_t nowMillis() const;
+
+    // game time that passed between the last two frames
+    Micros frameDelta() const;
+    float deltaSeconds() const;
+
+    // unscaled time that passed between the last two frames, keeps running while paused
+    Micros realFrameDelta() const;
+    float realDeltaSeconds() const;
+
+    // unscaled time since the clock was created, for things like logging intervals
+    Micros realNow() const;
+    time_t realNowMillis() const;
+
+    // Simulation time, moved on by one fixed step at the start of every tick. A frame can run several
+    // ticks, and timers, scheduled tasks and the crowd's deadlines read this so each of them sees its own time
+    void beginTick(float stepSeconds);
+    Micros tickNow() const;
+    time_t tickNowMillis() const;
+
+    void setPaused(bool paused);
+    bool isPaused() const;
+
+    // 2 runs the game at double speed, 0.5 at half
+    void setScale(float scale);
+    float getScale() const;
+
+    // add game time on the next frame without waiting for it, e.g. to fast-forward a soak test
+    void advance(Micros amount);
+
+    // replace where time comes from, in microseconds. The current time carries on from the new source
+    void setSource(Source source);
+
+    // forget the time since the last sample, so e.g. loading doesn't show up as one huge frame
+    void resync();
+
+    DISALLOW_COPY_AND_ASSIGN(GameClock);
+private:
+    static Micros steadyMicros();
+
+    Source m_source = steadyMicros;
+    Micros m_lastSample = 0;
+
+    Micros m_realNow = 0;
+    Micros m_realDelta = 0;
+
+    Micros m_now = 0;
+    Micros m_delta = 0;
+    double m_scaleRemainder = 0; // sub-microsecond leftovers of scaling, so they don't get lost
+
+    Micros m_pendingAdvance = 0;
+
+    double m_tickNow = 0; // in microseconds, so steps that aren't whole microseconds don't drift
+
+    bool m_paused = false;
+    float m_scale = 1;
+};
@@ -0,0 +1,100 @@
+#include "HandlePool.h"
+
+namespace
+{
+    // not worth a pass over every slot for fewer than this
+    constexpr uint32_t MIN_FREE_TO_COMPACT = 64;
+}
+
+HandlePool::Allocation HandlePool::allocate()
+{
+    uint32_t index;
+    if (!m_freeEntries.empty())
+    {
+        index = m_freeEntries.back();
+        m_freeEntries.pop_back();
+    }
+    else
+    {
+        index = uint32_t(m_entries.size());
+        if (index > INDEX_MASK)
+        {
+            LOG_ERROR("Out of handles, %u items at once is too many!", index);
+        }
+
+        m_entries.emplace_back();
+    }
+
+    // always at the end, reusing a hole would put the new item before older ones
+    Allocation allocation;
+    allocation.slot = uint32_t(m_handleAt.size());
+    m_handleAt.push_back(NONE);
+
+    Entry& entry = m_entries[index];
+    entry.slot = allocation.slot;
+
+    allocation.handle = index | (entry.generation << INDEX_BITS);
+    m_handleAt[allocation.slot] = allocation.handle;
+
+    return allocation;
+}
+
+void HandlePool::release(uint32_t handle)
+{
+    if (!contains(handle))
+        return;
+
+    Entry& entry = m_entries[indexOf(handle)];
+
+    m_handleAt[entry.slot] = NONE;
+    m_freeSlots++;
+
+    // anyone still holding this handle will find it doesn't match anymore
+    entry.slot = NONE;
+    entry.generation++;
+
+    // out of generations, wrapping around would make old handles valid again. Never hand it out again.
+    // That also keeps the all-ones handle, NONE, from ever being made
+    if (entry.generation < MAX_GENERATION)
+        m_freeEntries.push_back(indexOf(handle));
+}
+
+bool HandlePool::contains(uint32_t handle) const
+{
+    const uint32_t index = indexOf(handle);
+    if (handle == NONE || index >= m_entries.size())
+        return false;
+
+    const Entry& entry = m_entries[index];
+    return entry.slot != NONE && entry.generation == generationOf(handle);
+}
+
+uint32_t HandlePool::slotOf(uint32_t handle) const
+{
+    return contains(handle) ? m_entries[indexOf(handle)].slot : NONE;
+}
+
+uint32_t HandlePool::handleAt(uint32_t slot) const
+{
+    return slot < m_handleAt.size() ? m_handleAt[slot] : NONE;
+}
+
+uint32_t HandlePool::slotCount() const
+{
+    return uint32_t(m_handleAt.size());
+}
+
+uint32_t HandlePool::size() const
+{
+    return slotCount() - freeCount();
+}
+
+uint32_t HandlePool::freeCount() const
+{
+    return m_freeSlots;
+}
+
+bool HandlePool::wantsCompaction() const
+{
+    return freeCount() >= MIN_FREE_TO_COMPACT && freeCount() * 4 >= slotCount();
+}
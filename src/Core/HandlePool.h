@@ -0,0 +1,95 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "Core.h"
+
+// Keeps track of which slots of a set of dense arrays are in use, and hands out handles that stay
+// valid while the item behind them moves around. New items always go at the end, so slot order is
+// creation order. Released slots stay empty until compact() closes the gaps without reordering
+// anything, while released handles go on a free list to be handed out again.
+// A handle carries a generation, so one that outlived its item is told apart from the item that
+// took its place. An entry whose generation runs out is retired rather than wrapped around, so a
+// stale handle can never match again.
+// The pool only does the bookkeeping; moving the actual data is up to the owner, see CrowdStore.
+class HandlePool
+{
+public:
+    static constexpr uint32_t NONE = UINT32_MAX;
+
+    HandlePool() = default;
+
+    struct Allocation
+    {
+        uint32_t handle;
+        uint32_t slot; // always the new last slot, slotCount() - 1
+    };
+
+    Allocation allocate();
+    // the slot stays empty until the next compact(), the handle is invalid from now on
+    void release(uint32_t handle);
+
+    bool contains(uint32_t handle) const;
+    uint32_t slotOf(uint32_t handle) const;
+    // NONE for free slots
+    uint32_t handleAt(uint32_t slot) const;
+
+    uint32_t slotCount() const;
+    uint32_t size() const;     // slots in use
+    uint32_t freeCount() const;
+
+    // true when enough slots are free that compacting is worth the copying
+    bool wantsCompaction() const;
+
+    // move every used slot down over the free ones, keeping their order, then drop the free ones.
+    // Calls move(from, to) for every slot that moves, with to < from, before it returns the new slotCount()
+    template<typename Mover>
+    uint32_t compact(Mover&& move)
+    {
+        uint32_t to = 0;
+        for (uint32_t from = 0; from < slotCount(); from++)
+        {
+            const uint32_t handle = m_handleAt[from];
+            if (handle == NONE)
+                continue;
+
+            if (from != to)
+            {
+                move(from, to);
+
+                m_handleAt[to] = handle;
+                m_entries[indexOf(handle)].slot = to;
+            }
+
+            to++;
+        }
+
+        m_handleAt.resize(to);
+        m_freeSlots = 0;
+
+        return to;
+    }
+
+    DISALLOW_COPY_AND_ASSIGN(HandlePool);
+private:
+    // up to a million items at once, the other 12 bits of a handle are its generation
+    static constexpr uint32_t INDEX_BITS = 20;
+    static constexpr uint32_t INDEX_MASK = (1u << INDEX_BITS) - 1;
+    static constexpr uint32_t MAX_GENERATION = (1u << (32 - INDEX_BITS)) - 1;
+
+    static uint32_t indexOf(uint32_t handle) { return handle & INDEX_MASK; }
+    static uint32_t generationOf(uint32_t handle) { return handle >> INDEX_BITS; }
+
+    struct Entry
+    {
+        uint32_t slot = NONE;
+        uint32_t generation = 0;
+    };
+
+    std::vector<Entry> m_entries;      // indexed by the low bits of a handle
+    std::vector<uint32_t> m_freeEntries;
+
+    std::vector<uint32_t> m_handleAt;  // indexed by slot
+    uint32_t m_freeSlots = 0;          // released since the last compact()
+};
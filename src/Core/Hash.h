@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Kept out of Util.h so code without the rest of the engine (e.g. the tools) can use it too
+namespace Util
+{
+    constexpr std::size_t hashBytes(const char* data, std::size_t length)
+    {
+// value casts rather than pointer casts, so this stays usable in constant expressions
+#define get16bits(d) ((uint32_t(uint8_t((d)[1])) << 8) + uint32_t(uint8_t((d)[0])))
+
+        auto hash = uint32_t(length);
+
+        if (length <= 0 || data == nullptr) return 0;
+
+        int rem = length & 3;
+        length >>= 2;
+
+        /* Main loop */
+        for (; length > 0; length--)
+        {
+            hash += get16bits(data);
+            uint32_t tmp = (get16bits(data + 2) << 11) ^ hash;
+            hash = (hash << 16) ^ tmp;
+            data += 2 * sizeof(uint16_t);
+            hash += hash >> 11;
+        }
+
+        /* Handle end cases */
+        switch (rem)
+        {
+        case 3: hash += get16bits(data);
+            hash ^= hash << 16;
+            hash ^= ((signed char)data[sizeof(uint16_t)]) << 18;
+            hash += hash >> 11;
+            break;
+        case 2: hash += get16bits(data);
+            hash ^= hash << 11;
+            hash += hash >> 17;
+            break;
+        case 1: hash += (signed char)*data;
+            hash ^= hash << 10;
+            hash += hash >> 1;
+        }
+
+        /* Force "avalanching" of final 127 bits */
+        hash ^= hash << 3;
+        hash += hash >> 5;
+        hash ^= hash << 4;
+        hash += hash >> 17;
+        hash ^= hash << 25;
+        hash += hash >> 6;
+
+        return hash;
+    }
+}
@@ -0,0 +1,353 @@
+#include "JobSystem.h"
+
+#include <algorithm>
+
+namespace
+{
+    // index of the worker running on this thread, -1 on threads that aren't workers
+    thread_local int t_workerIndex = -1;
+}
+
+JobSystem::JobSystem(int threadCount)
+{
+    startWorkers(threadCount);
+}
+
+JobSystem::~JobSystem()
+{
+    stopWorkers();
+}
+
+void JobSystem::setThreadCount(int threadCount)
+{
+    stopWorkers();
+    startWorkers(threadCount);
+}
+
+int JobSystem::getThreadCount() const
+{
+    return int(m_workers.size());
+}
+
+JobSystem::Handle JobSystem::schedule(Work work, std::initializer_list<Handle> dependencies)
+{
+    Job* job = allocate();
+    job->work = std::move(work);
+    job->parent = nullptr;
+    job->unfinished = 1;
+    job->blockers = 1; // held until all dependencies are registered
+
+    const Handle handle = { job, job->generation.load() };
+
+    for (const Handle& dependency : dependencies)
+        addDependency(job, dependency);
+
+    unblock(job);
+
+    return handle;
+}
+
+JobSystem::Handle JobSystem::parallelFor(size_t count, size_t batchSize, RangeWork body,
+                                         std::initializer_list<Handle> dependencies)
+{
+    batchSize = std::max<size_t>(batchSize, 1);
+
+    Job* parent = allocate();
+    parent->range = std::move(body);
+    parent->parent = nullptr;
+    parent->unfinished = 1; // held by the spawning job until every batch is queued
+    parent->blockers = 0;
+
+    const Handle handle = { parent, parent->generation.load() };
+
+    // the batches are only spawned once the dependencies are done
+    schedule([this, parent, count, batchSize]() {
+        for (size_t begin = 0; begin < count; begin += batchSize)
+        {
+            const size_t end = std::min(begin + batchSize, count);
+
+            Job* batch = allocate();
+            batch->work = [parent, begin, end]() { parent->range(begin, end); };
+            batch->parent = parent;
+            batch->unfinished = 1;
+            batch->blockers = 0;
+
+            parent->unfinished++;
+            enqueue(batch);
+        }
+
+        // let go of the hold, if all batches already ran (or count was 0) this finishes the parallelFor
+        finish(parent);
+    }, dependencies);
+
+    return handle;
+}
+
+bool JobSystem::isDone(Handle handle) const
+{
+    return handle.job == nullptr || handle.job->generation.load() != handle.generation;
+}
+
+void JobSystem::wait(Handle handle)
+{
+    while (!isDone(handle))
+    {
+        // help out instead of sleeping
+        if (Job* job = t_workerIndex >= 0 ? pop(t_workerIndex) : nullptr)
+            execute(job);
+        else if (Job* stolen = steal(t_workerIndex))
+            execute(stolen);
+        else
+            std::this_thread::yield();
+    }
+}
+
+std::vector<JobSystem::WorkerStats> JobSystem::getStats() const
+{
+    const float elapsedMs = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - m_statsStart).count();
+
+    std::vector<WorkerStats> stats;
+    stats.reserve(m_workers.size());
+
+    for (const auto& worker : m_workers)
+    {
+        WorkerStats workerStats;
+        workerStats.jobs = worker->jobs.load();
+        workerStats.steals = worker->steals.load();
+        workerStats.busyMs = float(worker->busyNs.load()) / 1000000.0f;
+        workerStats.utilization = elapsedMs > 0 ? std::min(workerStats.busyMs / elapsedMs, 1.0f) : 0;
+
+        stats.push_back(workerStats);
+    }
+
+    return stats;
+}
+
+void JobSystem::resetStats()
+{
+    for (const auto& worker : m_workers)
+    {
+        worker->jobs = 0;
+        worker->steals = 0;
+        worker->busyNs = 0;
+    }
+
+    m_statsStart = std::chrono::steady_clock::now();
+}
+
+void JobSystem::startWorkers(int threadCount)
+{
+#ifdef PLATFORM_EMSCRIPTEN
+    threadCount = 0; // no threads to be had
+#else
+    if (threadCount <= 0)
+        threadCount = std::max(int(std::thread::hardware_concurrency()) - 1, 1);
+#endif
+
+    m_stopping = false;
+
+    for (int i = 0; i < threadCount; i++)
+        m_workers.push_back(std::make_unique<Worker>());
+
+    // only start them once the vector won't change anymore, they steal from each other
+    for (int i = 0; i < threadCount; i++)
+        m_workers[i]->thread = std::thread(&JobSystem::workerLoop, this, i);
+
+    resetStats();
+
+    LOG_INFO("Started job system with %i worker threads", threadCount);
+}
+
+void JobSystem::stopWorkers()
+{
+    {
+        std::lock_guard lock(m_sleepMutex);
+        m_stopping = true;
+    }
+    m_sleepCv.notify_all();
+
+    // workers only leave once they find no more jobs anywhere
+    for (auto& worker : m_workers)
+    {
+        if (worker->thread.joinable())
+            worker->thread.join();
+    }
+
+    m_workers.clear();
+}
+
+void JobSystem::workerLoop(int index)
+{
+    t_workerIndex = index;
+    Worker& self = *m_workers[index];
+
+    while (true)
+    {
+        Job* job = pop(index);
+        if (!job)
+        {
+            job = steal(index);
+            if (job)
+                self.steals++;
+        }
+
+        if (job)
+        {
+            const auto start = std::chrono::steady_clock::now();
+            execute(job);
+            self.busyNs += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+            self.jobs++;
+
+            continue;
+        }
+
+        std::unique_lock lock(m_sleepMutex);
+        if (m_stopping && m_queued == 0)
+            break;
+
+        m_sleepCv.wait(lock, [this] { return m_stopping || m_queued > 0; });
+    }
+
+    t_workerIndex = -1;
+}
+
+JobSystem::Job* JobSystem::allocate()
+{
+    std::lock_guard lock(m_poolMutex);
+
+    if (m_freeJobs.empty())
+        return &m_jobs.emplace_back();
+
+    Job* job = m_freeJobs.back();
+    m_freeJobs.pop_back();
+
+    return job;
+}
+
+void JobSystem::addDependency(Job* job, Handle dependency)
+{
+    if (dependency.job == nullptr)
+        return;
+
+    std::lock_guard lock(dependency.job->mutex);
+
+    // already finished, nothing to wait for
+    if (dependency.job->generation.load() != dependency.generation)
+        return;
+
+    job->blockers++;
+    dependency.job->dependents.push_back(job);
+}
+
+void JobSystem::unblock(Job* job)
+{
+    if (--job->blockers == 0)
+        enqueue(job);
+}
+
+void JobSystem::enqueue(Job* job)
+{
+    if (m_workers.empty())
+    {
+        execute(job);
+        return;
+    }
+
+    // jobs spawned by a worker stay on its queue, everything else is spread out
+    const int index = t_workerIndex >= 0 ? t_workerIndex : int(m_nextQueue++ % m_workers.size());
+
+    m_queued++;
+
+    {
+        std::lock_guard lock(m_workers[index]->mutex);
+        m_workers[index]->queue.push_back(job);
+    }
+
+    {
+        std::lock_guard lock(m_sleepMutex); // so a worker about to sleep can't miss the notify
+    }
+    m_sleepCv.notify_one();
+}
+
+JobSystem::Job* JobSystem::pop(int index)
+{
+    Worker& worker = *m_workers[index];
+    std::lock_guard lock(worker.mutex);
+
+    if (worker.queue.empty())
+        return nullptr;
+
+    Job* job = worker.queue.back();
+    worker.queue.pop_back();
+    m_queued--;
+
+    return job;
+}
+
+JobSystem::Job* JobSystem::steal(int thief)
+{
+    const int count = int(m_workers.size());
+    const int start = thief >= 0 ? thief + 1 : 0;
+
+    for (int i = 0; i < count; i++)
+    {
+        const int victimIndex = (start + i) % count;
+        if (victimIndex == thief)
+            continue;
+
+        Worker& victim = *m_workers[victimIndex];
+        std::lock_guard lock(victim.mutex);
+
+        if (victim.queue.empty())
+            continue;
+
+        // the oldest job, which is the least likely to be in the victim's cache
+        Job* job = victim.queue.front();
+        victim.queue.pop_front();
+        m_queued--;
+
+        return job;
+    }
+
+    return nullptr;
+}
+
+void JobSystem::execute(Job* job)
+{
+    if (job->work)
+    {
+        job->work();
+        job->work.reset();
+    }
+
+    finish(job);
+}
+
+void JobSystem::finish(Job* job)
+{
+    if (--job->unfinished != 0)
+        return;
+
+    Job* parent = job->parent;
+
+    std::vector<Job*> dependents;
+    {
+        std::lock_guard lock(job->mutex);
+        job->generation++; // this is what makes handles report the job as done
+        dependents.swap(job->dependents);
+    }
+
+    job->range.reset();
+    job->parent = nullptr;
+
+    {
+        std::lock_guard lock(m_poolMutex);
+        m_freeJobs.push_back(job);
+    }
+
+    for (Job* dependent : dependents)
+        unblock(dependent);
+
+    if (parent)
+        finish(parent);
+}
@@ -0,0 +1,126 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <initializer_list>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "Core.h"
+#include "SmallFunction.h"
+
+// A fixed set of worker threads that run small jobs.
+// Every worker has its own queue, and idle workers steal from the others, so jobs that spawn more
+// jobs mostly stay on the thread that has their data in cache. Jobs can wait on other jobs, and
+// parallelFor splits a range into batches across all workers.
+// With no worker threads (Emscripten has none) jobs just run on the calling thread.
+class JobSystem
+{
+    struct Job;
+
+public:
+    using Work = SmallFunction<void(), 64>;
+    using RangeWork = SmallFunction<void(size_t begin, size_t end), 48>;
+
+    // refers to a scheduled job. Stays valid after the job finished
+    struct Handle
+    {
+        Job* job = nullptr;
+        uint32_t generation = 0;
+    };
+
+    // 0 threads picks one less than the hardware has, leaving a core for the main thread
+    explicit JobSystem(int threadCount = 0);
+    ~JobSystem();
+
+    // waits for queued jobs to finish, then restarts the workers
+    void setThreadCount(int threadCount);
+    int getThreadCount() const;
+
+    // run work once every dependency has finished
+    Handle schedule(Work work, std::initializer_list<Handle> dependencies = {});
+
+    // call body on [begin, end) batches of at most batchSize that together cover [0, count).
+    // body is called from several threads at once
+    Handle parallelFor(size_t count, size_t batchSize, RangeWork body, std::initializer_list<Handle> dependencies = {});
+
+    bool isDone(Handle handle) const;
+
+    // block until the job is done, running other jobs in the meantime
+    void wait(Handle handle);
+
+    struct WorkerStats
+    {
+        unsigned int jobs = 0;
+        unsigned int steals = 0;
+        float busyMs = 0;
+        float utilization = 0; // fraction of the time since resetStats() spent running jobs
+    };
+
+    std::vector<WorkerStats> getStats() const;
+    void resetStats();
+
+    DISALLOW_COPY_AND_ASSIGN(JobSystem);
+private:
+    struct Job
+    {
+        Work work;
+        RangeWork range; // body of a parallelFor, shared by its batches
+
+        Job* parent = nullptr; // batches finish their parallelFor when the last one is done
+
+        std::atomic<int> unfinished{0}; // this job and its batches
+        std::atomic<int> blockers{0};   // unfinished dependencies
+        std::atomic<uint32_t> generation{0}; // bumped when the job finishes
+
+        std::mutex mutex; // guards dependents against the job finishing
+        std::vector<Job*> dependents;
+    };
+
+    struct Worker
+    {
+        std::thread thread;
+
+        std::mutex mutex;
+        std::deque<Job*> queue; // the owner works from the back, thieves take from the front
+
+        std::atomic<unsigned int> jobs{0};
+        std::atomic<unsigned int> steals{0};
+        std::atomic<int64_t> busyNs{0};
+    };
+
+    void startWorkers(int threadCount);
+    void stopWorkers();
+    void workerLoop(int index);
+
+    Job* allocate();
+    void addDependency(Job* job, Handle dependency);
+    void unblock(Job* job);
+
+    void enqueue(Job* job);
+    Job* pop(int index);
+    Job* steal(int thief);
+
+    void execute(Job* job);
+    void finish(Job* job);
+
+    std::vector<std::unique_ptr<Worker>> m_workers;
+    std::atomic<unsigned int> m_nextQueue{0};
+
+    std::atomic<int> m_queued{0};
+    std::mutex m_sleepMutex;
+    std::condition_variable m_sleepCv;
+    bool m_stopping = false;
+
+    // jobs are recycled, and never move so handles and dependents can point at them
+    std::mutex m_poolMutex;
+    std::deque<Job> m_jobs;
+    std::vector<Job*> m_freeJobs;
+
+    std::chrono::steady_clock::time_point m_statsStart;
+};
@@ -0,0 +1,154 @@
+#include "Random.h"
+
+#include <chrono>
+#include <unordered_map>
+
+#include "Hash.h"
+
+namespace
+{
+    constexpr uint64_t MULTIPLIER = 6364136223846793005ULL;
+
+    // spreads similar inputs (names, indices) far apart before they become a PCG stream
+    uint64_t splitmix(uint64_t x)
+    {
+        x += 0x9E3779B97F4A7C15ULL;
+        x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+        return x ^ (x >> 31);
+    }
+
+    uint64_t streamId(const std::string& name, uint64_t index)
+    {
+        return splitmix(Util::hashBytes(name.c_str(), name.size()) ^ splitmix(index));
+    }
+
+    inline uint32_t step(uint64_t& state, uint64_t increment)
+    {
+        const uint64_t old = state;
+        state = old * MULTIPLIER + increment;
+
+        const auto xorShifted = uint32_t(((old >> 18u) ^ old) >> 27u);
+        const auto rotation = uint32_t(old >> 59u);
+        return (xorShifted >> rotation) | (xorShifted << ((32 - rotation) & 31));
+    }
+
+    // the top 24 bits, so every value is exactly representable and 1.0 can't come out
+    inline float toFloat(uint32_t bits)
+    {
+        return float(bits >> 8) * (1.0f / 16777216.0f);
+    }
+
+    uint64_t s_seed = 0;
+    bool s_seeded = false;
+    std::unordered_map<std::string, Random> s_streams;
+}
+
+Random::Random(uint64_t seed, uint64_t stream)
+{
+    reseed(seed, stream);
+}
+
+void Random::reseed(uint64_t seed, uint64_t stream)
+{
+    // the standard PCG seeding sequence
+    m_state = 0;
+    m_increment = (stream << 1u) | 1u;
+    nextU32();
+    m_state += seed;
+    nextU32();
+}
+
+uint32_t Random::nextU32()
+{
+    return step(m_state, m_increment);
+}
+
+float Random::nextFloat()
+{
+    return toFloat(nextU32());
+}
+
+float Random::uniform(float min, float max)
+{
+    return min + nextFloat() * (max - min);
+}
+
+uint32_t Random::below(uint32_t bound)
+{
+    // Lemire's multiply and reject, only ever retries for a tiny slice of outputs
+    uint64_t product = uint64_t(nextU32()) * bound;
+    auto low = uint32_t(product);
+    if (low < bound)
+    {
+        const uint32_t threshold = uint32_t(-bound) % bound;
+        while (low < threshold)
+        {
+            product = uint64_t(nextU32()) * bound;
+            low = uint32_t(product);
+        }
+    }
+
+    return uint32_t(product >> 32);
+}
+
+bool Random::chance(float probability)
+{
+    return nextFloat() < probability;
+}
+
+void Random::fill(float* out, size_t count)
+{
+    // keep the state in a register for the whole batch instead of going through the member
+    uint64_t state = m_state;
+    const uint64_t increment = m_increment;
+
+    for (size_t i = 0; i < count; i++)
+        out[i] = toFloat(step(state, increment));
+
+    m_state = state;
+}
+
+void Random::fill(float* out, size_t count, float min, float max)
+{
+    fill(out, count);
+
+    const float range = max - min;
+    for (size_t i = 0; i < count; i++)
+        out[i] = min + out[i] * range;
+}
+
+void RandomStreams::setSeed(uint64_t seed)
+{
+    s_seed = seed;
+    s_seeded = true;
+
+    for (auto& [name, random] : s_streams)
+        random.reseed(seed, streamId(name, 0));
+}
+
+uint64_t RandomStreams::getSeed()
+{
+    if (!s_seeded)
+    {
+        s_seed = splitmix(uint64_t(std::chrono::system_clock::now().time_since_epoch().count()));
+        s_seeded = true;
+    }
+
+    return s_seed;
+}
+
+Random& RandomStreams::stream(const std::string& name)
+{
+    const auto existing = s_streams.find(name);
+    if (existing != s_streams.end())
+        return existing->second;
+
+    return s_streams.emplace(name, Random(getSeed(), streamId(name, 0))).first->second;
+}
+
+Random RandomStreams::derive(const std::string& name, uint64_t index)
+{
+    // index 0 is the named stream itself, so start derived ones after it
+    return Random(getSeed(), streamId(name, index + 1));
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "Core.h"
+
+// A small, fast PCG32 generator. Unlike rand() every stream carries its own state, so two subsystems
+// never disturb each other's sequence and a worker thread can own one without any locking.
+// The same seed and stream always give the same numbers on every platform.
+class Random
+{
+public:
+    explicit Random(uint64_t seed = 0, uint64_t stream = 0);
+
+    void reseed(uint64_t seed, uint64_t stream);
+
+    uint32_t nextU32();
+
+    // [0, 1)
+    float nextFloat();
+    // [min, max)
+    float uniform(float min, float max);
+    // [0, bound), without the modulo bias of rand() % bound. bound must not be 0
+    uint32_t below(uint32_t bound);
+    // true with the given probability
+    bool chance(float probability);
+
+    // write count floats in [0, 1) to out in one go, for loops that want a whole batch up front
+    void fill(float* out, size_t count);
+    // the same, scaled to [min, max)
+    void fill(float* out, size_t count, float min, float max);
+
+private:
+    uint64_t m_state = 0;
+    uint64_t m_increment = 1;
+};
+
+// Named generators that all derive from one seed, one per subsystem ("crowd", "costumes", "sfx", ...).
+// Setting the seed before the game is built (see --seed) makes a whole run reproducible.
+// stream() is for the main thread. Jobs should get their own Random from derive() instead.
+namespace RandomStreams
+{
+    // reseeds every stream handed out so far as well
+    void setSeed(uint64_t seed);
+    // picked from the clock the first time it's needed, unless setSeed() came first
+    uint64_t getSeed();
+
+    // the stream with this name, created on first use. The reference stays valid for the whole run
+    Random& stream(const std::string& name);
+
+    // a fresh generator for the given name and index, e.g. one per job batch
+    Random derive(const std::string& name, uint64_t index);
+}
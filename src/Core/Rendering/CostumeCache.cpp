@@ -0,0 +1,122 @@
+#include "CostumeCache.h"
+
+#include "GLState.h"
+#include "Outrospection.h"
+
+CostumeCache::CostumeCache() : m_framebuffer(CELL_WIDTH * COLUMNS, CELL_HEIGHT * ROWS, GL_RGBA)
+{
+    for (int cell = COLUMNS * ROWS - 1; cell >= 0; cell--)
+        m_freeCells.push_back(cell);
+
+    m_stats.capacity = COLUMNS * ROWS;
+
+    // RGBA color plus the depth/stencil renderbuffer every Framebuffer has
+    m_stats.vramBytes = size_t(CELL_WIDTH * COLUMNS) * (CELL_HEIGHT * ROWS) * (4 + 4);
+}
+
+TextureRegion CostumeCache::get(const CostumeCatalog::Costume& costume)
+{
+    const CostumeCatalog& catalog = Outrospection::get().costumeCatalog;
+    const Key key = catalog.indexOf(costume);
+
+    const auto f = m_entries.find(key);
+    if (f != m_entries.end())
+    {
+        m_stats.hits++;
+
+        // move to the front of the LRU list
+        m_lru.splice(m_lru.begin(), m_lru, f->second.lruPos);
+
+        return cellRegion(f->second.cell);
+    }
+
+    m_stats.misses++;
+
+    int cell;
+    if (!m_freeCells.empty())
+    {
+        cell = m_freeCells.back();
+        m_freeCells.pop_back();
+    }
+    else
+    {
+        // evict the least recently used costume
+        const Key victim = m_lru.back();
+        m_lru.pop_back();
+
+        cell = m_entries[victim].cell;
+        m_entries.erase(victim);
+
+        m_stats.evictions++;
+    }
+
+    render(cell, costume);
+
+    m_lru.push_front(key);
+    m_entries[key] = { cell, m_lru.begin() };
+    m_stats.entries = m_entries.size();
+
+    return cellRegion(cell);
+}
+
+const CostumeCache::Stats& CostumeCache::getStats() const
+{
+    return m_stats;
+}
+
+void CostumeCache::render(int cell, const CostumeCatalog::Costume& costume)
+{
+    auto& o = Outrospection::get();
+    const CostumeCatalog& catalog = o.costumeCatalog;
+    Framebuffer* previousFramebuffer = o.curFramebuffer;
+
+    m_framebuffer.bind();
+
+    const glm::ivec2 cellPos = glm::ivec2(cell % COLUMNS * CELL_WIDTH, cell / COLUMNS * CELL_HEIGHT);
+
+    // clear just this cell. GL's origin is the bottom left
+    glEnable(GL_SCISSOR_TEST);
+    glScissor(cellPos.x, m_framebuffer.resolution.y - cellPos.y - CELL_HEIGHT, CELL_WIDTH, CELL_HEIGHT);
+
+    GLfloat clearColor[4];
+    glGetFloatv(GL_COLOR_CLEAR_VALUE, clearColor);
+    glClearColor(0, 0, 0, 0);
+    glClear(GL_COLOR_BUFFER_BIT);
+    glClearColor(clearColor[0], clearColor[1], clearColor[2], clearColor[3]);
+
+    glDisable(GL_SCISSOR_TEST);
+
+    // accumulate alpha properly, which leaves the cell premultiplied
+    GLState::blendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+
+    for (int i = 0; i < CostumeCatalog::LAYER_COUNT; i++)
+    {
+        const Resource& layer = catalog.getPart(i, costume.parts[i]);
+        if (layer.empty())
+            continue;
+
+        const SimpleTexture& tex = o.textureManager.get(layer);
+        o.spriteBatch.submit(o.shaders["sprite"], tex.texId, cellPos, glm::vec2(CELL_WIDTH, CELL_HEIGHT), tex.getUV());
+    }
+
+    o.spriteBatch.flush();
+
+    GLState::blendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+    if (previousFramebuffer)
+        previousFramebuffer->bind();
+}
+
+TextureRegion CostumeCache::cellRegion(int cell) const
+{
+    const glm::vec2 res = m_framebuffer.resolution;
+    const glm::vec2 cellPos = glm::vec2(cell % COLUMNS * CELL_WIDTH, cell / COLUMNS * CELL_HEIGHT);
+
+    // rendered upside down, so top and bottom are swapped. Inset by half a texel to stay inside the cell
+    const float left = (cellPos.x + 0.5f) / res.x;
+    const float right = (cellPos.x + CELL_WIDTH - 0.5f) / res.x;
+    const float top = (res.y - cellPos.y - 0.5f) / res.y;
+    const float bottom = (res.y - cellPos.y - CELL_HEIGHT + 0.5f) / res.y;
+
+    return { m_framebuffer.getTexture(), glm::vec4(left, top, right, bottom) };
+}
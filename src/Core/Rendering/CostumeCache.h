@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstdint>
+#include <list>
+#include <unordered_map>
+
+#include "Core.h"
+#include "Types.h"
+#include "Core/CostumeCatalog.h"
+#include "Framebuffer.h"
+#include "SimpleTexture.h"
+
+// Renders every costume (the five layers of a human) once into a cell of an offscreen texture,
+// so a human can be drawn as a single sprite afterwards. Cells are reused least recently used first.
+// The cells hold premultiplied alpha, draw them with the "costume" shader.
+class CostumeCache
+{
+public:
+    // full costume art size, so the character maker's big human stays sharp
+    static constexpr int CELL_WIDTH = 768;
+    static constexpr int CELL_HEIGHT = 1080;
+    static constexpr int COLUMNS = 4;
+    static constexpr int ROWS = 2;
+
+    CostumeCache();
+
+    // returns the composited costume, rendering it first if it isn't cached
+    TextureRegion get(const CostumeCatalog::Costume& costume);
+
+    struct Stats
+    {
+        unsigned int hits = 0;
+        unsigned int misses = 0;
+        unsigned int evictions = 0;
+
+        unsigned int entries = 0;
+        unsigned int capacity = 0;
+        size_t vramBytes = 0;
+    };
+
+    const Stats& getStats() const;
+
+    DISALLOW_COPY_AND_ASSIGN(CostumeCache);
+private:
+    // CostumeCatalog::indexOf
+    typedef uint32_t Key;
+
+    struct Entry
+    {
+        int cell;
+        std::list<Key>::iterator lruPos;
+    };
+
+    void render(int cell, const CostumeCatalog::Costume& costume);
+    TextureRegion cellRegion(int cell) const;
+
+    Framebuffer m_framebuffer;
+
+    std::unordered_map<Key, Entry> m_entries;
+    std::list<Key> m_lru; // most recently used first
+    std::vector<int> m_freeCells;
+
+    Stats m_stats;
+};
@@ -0,0 +1,254 @@
+#include "CrowdRenderer.h"
+
+#include <algorithm>
+#include <cstddef>
+
+#include <External/stb_image.h>
+
+#include "GLState.h"
+#include "Outrospection.h"
+#include "Shader.h"
+#include "Core/File.h"
+
+CrowdRenderer::CrowdRenderer()
+{
+    // unit quad, stretched over every instance's rect in the vertex shader
+    const float corners[] = {
+        0.0f, 0.0f,
+        1.0f, 0.0f,
+        1.0f, 1.0f,
+
+        0.0f, 0.0f,
+        1.0f, 1.0f,
+        0.0f, 1.0f,
+    };
+
+    glGenVertexArrays(1, &m_vao);
+    glGenBuffers(1, &m_quadVBO);
+    glGenBuffers(1, &m_instanceVBO);
+
+    GLState::bindVertexArray(m_vao);
+
+    GLState::bindBuffer(GL_ARRAY_BUFFER, m_quadVBO);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(corners), corners, GL_STATIC_DRAW);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), nullptr);
+
+    GLState::bindBuffer(GL_ARRAY_BUFFER, m_instanceVBO);
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(Instance), (void*) offsetof(Instance, rect));
+    glVertexAttribDivisor(1, 1);
+    glEnableVertexAttribArray(2);
+    glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, sizeof(Instance), (void*) offsetof(Instance, layers));
+    glVertexAttribDivisor(2, 1);
+    glEnableVertexAttribArray(3);
+    glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, sizeof(Instance), (void*) offsetof(Instance, extra));
+    glVertexAttribDivisor(3, 1);
+
+    GLState::bindVertexArray(0);
+    GLState::bindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+CrowdRenderer::~CrowdRenderer()
+{
+    // the decode job writes into this object, don't let it outlive us
+    if (m_building)
+        Outrospection::get().jobSystem.wait(m_build);
+}
+
+int CrowdRenderer::slotFor(const Resource& layer)
+{
+    if (layer.empty())
+        return -1;
+
+    auto [it, inserted] = m_slots.try_emplace(layer, int(m_slotResources.size()));
+    if (inserted)
+        m_slotResources.push_back(layer);
+
+    return it->second;
+}
+
+bool CrowdRenderer::hasSlot(int slot) const
+{
+    // -1 (empty layer) is always drawable
+    return slot < m_uploadedSlots;
+}
+
+void CrowdRenderer::add(const glm::vec2& pos, const glm::vec2& size, bool flip, float opacity,
+                        const std::array<int, LAYER_COUNT>& slots)
+{
+    m_instances.push_back({
+        glm::vec4(pos.x, pos.y, size.x, size.y),
+        glm::vec4(slots[0], slots[1], slots[2], slots[3]),
+        glm::vec3(slots[4], flip ? 1.0f : 0.0f, opacity)
+    });
+}
+
+void CrowdRenderer::begin()
+{
+    JobSystem& jobSystem = Outrospection::get().jobSystem;
+
+    if (m_building)
+    {
+        if (!jobSystem.isDone(m_build))
+            return;
+
+        finishBuild();
+    }
+
+    // new layers were registered since the last build
+    if (int(m_slotResources.size()) > m_uploadedSlots)
+    {
+        startBuild();
+
+        // without worker threads the build already ran
+        if (jobSystem.isDone(m_build))
+            finishBuild();
+    }
+}
+
+void CrowdRenderer::draw(const Shader& shader)
+{
+    if (m_instances.empty())
+        return;
+
+    Outrospection::get().spriteBatch.flush();
+
+    GLState::bindVertexArray(m_vao);
+
+    GLState::bindBuffer(GL_ARRAY_BUFFER, m_instanceVBO);
+    const GLsizeiptr uploadSize = GLsizeiptr(m_instances.size() * sizeof(Instance));
+    glBufferData(GL_ARRAY_BUFFER, uploadSize, nullptr, GL_STREAM_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, uploadSize, m_instances.data());
+
+    shader.use();
+
+    GLState::activeTexture(GL_TEXTURE0);
+    GLState::bindTexture(GL_TEXTURE_2D_ARRAY, m_textureArray);
+
+    glDrawArraysInstanced(GL_TRIANGLES, 0, 6, GLsizei(m_instances.size()));
+
+    m_frameStats.drawCalls++;
+    m_frameStats.humans += m_instances.size();
+
+    m_instances.clear();
+}
+
+void CrowdRenderer::endFrame()
+{
+    m_lastFrameStats = m_frameStats;
+    m_frameStats = Stats();
+}
+
+const CrowdRenderer::Stats& CrowdRenderer::lastFrameStats() const
+{
+    return m_lastFrameStats;
+}
+
+void CrowdRenderer::startBuild()
+{
+    m_buildingSlots = int(m_slotResources.size());
+
+    LOG("Building crowd texture array with %i layers...", m_buildingSlots);
+
+    m_buildLayers = m_slotResources;
+    m_building = true;
+    m_build = Outrospection::get().jobSystem.schedule([this] {
+        m_buildPixels = decodeSlices(m_buildLayers);
+    });
+}
+
+void CrowdRenderer::finishBuild()
+{
+    uploadSlices(m_buildPixels, m_buildingSlots);
+
+    m_buildPixels = std::vector<unsigned char>();
+    m_building = false;
+}
+
+void CrowdRenderer::uploadSlices(const std::vector<unsigned char>& pixels, int sliceCount)
+{
+    if (m_textureArray != 0)
+        GLState::deleteTexture(m_textureArray);
+
+    glGenTextures(1, &m_textureArray);
+    GLState::bindTexture(GL_TEXTURE_2D_ARRAY, m_textureArray);
+
+    glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_RGBA8, SLICE_WIDTH, SLICE_HEIGHT, sliceCount, 0,
+                 GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+
+    // the crowd is drawn smaller than the slices, so mipmaps keep it from shimmering
+    glGenerateMipmap(GL_TEXTURE_2D_ARRAY);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+    m_uploadedSlots = sliceCount;
+}
+
+// Decodes every layer and box-filters it down to the slice size. Runs off the main thread.
+std::vector<unsigned char> CrowdRenderer::decodeSlices(const std::vector<Resource>& layers)
+{
+    constexpr size_t sliceSize = SLICE_WIDTH * SLICE_HEIGHT * 4;
+
+    std::vector<unsigned char> pixels(sliceSize * layers.size(), 0);
+
+    for (size_t slice = 0; slice < layers.size(); slice++)
+    {
+        File file = File(layers[slice]);
+        const std::vector<unsigned char> data = file.readAllBytes();
+
+        int width = 0, height = 0, components = 0;
+        unsigned char* image = stbi_load_from_memory(data.data(), int(data.size()), &width, &height, &components, 4);
+
+        if (!image)
+        {
+            LOG_ERROR("Crowd layer failed to load at path: %s", layers[slice].getPath());
+            continue; // leave the slice transparent
+        }
+
+        unsigned char* out = pixels.data() + slice * sliceSize;
+
+        for (int y = 0; y < SLICE_HEIGHT; y++)
+        {
+            const int y0 = y * height / SLICE_HEIGHT;
+            const int y1 = std::max(y0 + 1, (y + 1) * height / SLICE_HEIGHT);
+
+            for (int x = 0; x < SLICE_WIDTH; x++)
+            {
+                const int x0 = x * width / SLICE_WIDTH;
+                const int x1 = std::max(x0 + 1, (x + 1) * width / SLICE_WIDTH);
+
+                // average with premultiplied alpha so transparent pixels don't bleed their color
+                float r = 0, g = 0, b = 0, a = 0;
+                for (int sy = y0; sy < y1; sy++)
+                {
+                    for (int sx = x0; sx < x1; sx++)
+                    {
+                        const unsigned char* p = image + (sy * width + sx) * 4;
+                        const float alpha = p[3] / 255.0f;
+
+                        r += p[0] * alpha;
+                        g += p[1] * alpha;
+                        b += p[2] * alpha;
+                        a += alpha;
+                    }
+                }
+
+                unsigned char* o = out + (y * SLICE_WIDTH + x) * 4;
+                if (a > 0)
+                {
+                    o[0] = (unsigned char) (r / a + 0.5f);
+                    o[1] = (unsigned char) (g / a + 0.5f);
+                    o[2] = (unsigned char) (b / a + 0.5f);
+                    o[3] = (unsigned char) (a * 255.0f / float((y1 - y0) * (x1 - x0)) + 0.5f);
+                }
+            }
+        }
+
+        stbi_image_free(image);
+    }
+
+    return pixels;
+}
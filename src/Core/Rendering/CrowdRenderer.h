@@ -0,0 +1,100 @@
+#pragma once
+
+#include <array>
+#include <unordered_map>
+#include <vector>
+
+#ifdef USE_GLFM
+#include "glfm.h"
+#else
+#include <glad/glad.h>
+#endif
+
+#include <glm.hpp>
+
+#include "Core.h"
+#include "Types.h"
+#include "Core/JobSystem.h"
+#include "Core/Resource.h"
+
+class Shader;
+
+// Draws a whole crowd of layered humans with one instanced draw call.
+// Every costume layer lives in one slice of a texture array, and the fragment shader stacks the
+// five layers of a human itself, so no per-layer texture binds or draw calls are needed.
+class CrowdRenderer
+{
+public:
+    static constexpr int LAYER_COUNT = 5;
+
+    // slices are stored at half the size of the costume art, which is still twice what the crowd is drawn at
+    static constexpr int SLICE_WIDTH = 384;
+    static constexpr int SLICE_HEIGHT = 540;
+
+    CrowdRenderer();
+    ~CrowdRenderer();
+
+    // returns the texture array slice for a costume layer, registering it if it's new. -1 means "draw nothing"
+    int slotFor(const Resource& layer);
+
+    // true once the slice has been uploaded and can be drawn from
+    bool hasSlot(int slot) const;
+
+    // queue one human for this frame's crowd draw
+    void add(const glm::vec2& pos, const glm::vec2& size, bool flip, float opacity,
+             const std::array<int, LAYER_COUNT>& slots);
+
+    // polls the background texture array build. Call before adding humans for the frame
+    void begin();
+
+    // draw all queued humans. Flushes the sprite batch first so the crowd lands in painter's order
+    void draw(const Shader& shader);
+
+    void endFrame();
+
+    struct Stats
+    {
+        unsigned int drawCalls = 0;
+        unsigned int humans = 0;
+    };
+
+    const Stats& lastFrameStats() const;
+
+    DISALLOW_COPY_AND_ASSIGN(CrowdRenderer);
+private:
+    struct Instance
+    {
+        glm::vec4 rect;      // position, size
+        glm::vec4 layers;    // slices of FACE, LEGS, TORSO, HAT
+        glm::vec3 extra;     // slice of HANDS, flip, opacity
+    };
+
+    void startBuild();
+    void finishBuild();
+    void uploadSlices(const std::vector<unsigned char>& pixels, int sliceCount);
+
+    static std::vector<unsigned char> decodeSlices(const std::vector<Resource>& layers);
+
+    std::unordered_map<Resource, int, Hashes> m_slots;
+    std::vector<Resource> m_slotResources;
+
+    // number of slots present in the current texture array
+    int m_uploadedSlots = 0;
+    int m_buildingSlots = 0;
+
+    // decoded on the job system. The job owns both vectors until m_build is done
+    std::vector<Resource> m_buildLayers;
+    std::vector<unsigned char> m_buildPixels;
+    JobSystem::Handle m_build;
+    bool m_building = false;
+
+    std::vector<Instance> m_instances;
+
+    GLuint m_textureArray = 0;
+    GLuint m_vao = 0;
+    GLuint m_quadVBO = 0;
+    GLuint m_instanceVBO = 0;
+
+    Stats m_frameStats;
+    Stats m_lastFrameStats;
+};
@@ -0,0 +1,30 @@
+#include "FrameUniforms.h"
+
+#include <cstddef>
+
+#include "GLState.h"
+
+FrameUniforms::FrameUniforms()
+{
+    glGenBuffers(1, &m_ubo);
+
+    const Data data;
+    GLState::bindBuffer(GL_UNIFORM_BUFFER, m_ubo);
+    glBufferData(GL_UNIFORM_BUFFER, sizeof(Data), &data, GL_DYNAMIC_DRAW);
+
+    // stays bound to the binding point for the lifetime of the game
+    GLState::bindBufferBase(GL_UNIFORM_BUFFER, BINDING, m_ubo);
+}
+
+void FrameUniforms::setTarget(const glm::mat4& projection, const glm::vec2& resolution)
+{
+    GLState::bindBuffer(GL_UNIFORM_BUFFER, m_ubo);
+    glBufferSubData(GL_UNIFORM_BUFFER, offsetof(Data, projection), sizeof(glm::mat4), &projection);
+    glBufferSubData(GL_UNIFORM_BUFFER, offsetof(Data, resolution), sizeof(glm::vec2), &resolution);
+}
+
+void FrameUniforms::setTime(float time)
+{
+    GLState::bindBuffer(GL_UNIFORM_BUFFER, m_ubo);
+    glBufferSubData(GL_UNIFORM_BUFFER, offsetof(Data, time), sizeof(float), &time);
+}
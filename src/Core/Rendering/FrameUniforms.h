@@ -0,0 +1,51 @@
+#pragma once
+
+#ifdef USE_GLFM
+#include "glfm.h"
+#else
+#include <glad/glad.h>
+#endif
+
+#include <glm.hpp>
+
+#include "Core.h"
+
+// Per-frame data shared by every shader through one std140 uniform block:
+//
+//     layout (std140) uniform FrameData
+//     {
+//         mat4 projection;
+//         vec2 resolution;
+//         float time;
+//     };
+//
+// Shader links the block to BINDING, so updating it here reaches all programs without switching between them.
+class FrameUniforms
+{
+public:
+    static constexpr GLuint BINDING = 0;
+    static constexpr const char* BLOCK_NAME = "FrameData";
+
+    FrameUniforms();
+
+    // called by Framebuffer::bind with the target's ortho projection and size
+    void setTarget(const glm::mat4& projection, const glm::vec2& resolution);
+
+    // seconds, wraps around every 100 seconds to keep float precision
+    void setTime(float time);
+
+    DISALLOW_COPY_AND_ASSIGN(FrameUniforms);
+private:
+    // mirrors the std140 layout of the block
+    struct Data
+    {
+        glm::mat4 projection = glm::mat4(1);   // offset 0
+        glm::vec2 resolution = glm::vec2(0);   // offset 64
+        float time = 0;                        // offset 72
+        float padding = 0;                     // block size is rounded up to 80
+    };
+
+    static_assert(sizeof(Data) == 80, "FrameUniforms::Data must match the std140 layout of FrameData");
+
+    GLuint m_ubo = 0;
+};
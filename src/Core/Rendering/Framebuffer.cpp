@@ -1,9 +1,11 @@
 #include "Framebuffer.h"
 
+#include "GLState.h"
+
 #include "Outrospection.h"
 #include "Util.h"
 
-Framebuffer::Framebuffer(int width, int height) : isDefaultFramebuffer(false),
+Framebuffer::Framebuffer(int width, int height, GLint _format) : isDefaultFramebuffer(false), format(_format),
     defaultResolution(width, height), resolution(width, height)
 {
     scaleResolution(1.0);
@@ -11,10 +13,13 @@ Framebuffer::Framebuffer(int width, int height) : isDefaultFramebuffer(false),
 
 void Framebuffer::bind()
 {
-    glBindFramebuffer(GL_FRAMEBUFFER, id);
+    auto& o = Outrospection::get();
 
+    // anything still queued belongs to the previous target
+    o.spriteBatch.flush();
+
+    GLState::bindFramebuffer(id);
 
-    auto& o = Outrospection::get();
     if (isDefaultFramebuffer) // default fb letterboxing
     {
         glm::ivec2 windowRes = o.getWindowResolution();
@@ -43,22 +48,24 @@ void Framebuffer::bind()
     }
 
     
+    o.curFramebuffer = this;
     o.curFbResolution = &resolution;
 
     const glm::mat4 projection = glm::ortho(0.0f, float(resolution.x), float(resolution.y),
                                             0.0f, -1.0f, 1.0f);
 
-    // TODO should probs loop thru all shaders
-    o.shaders["sprite"].use();
-    o.shaders["sprite"].setMat4("projection", projection);
-
-    o.shaders["glyph"].use();
-    o.shaders["glyph"].setMat4("projection", projection);
+    // every shader reads these from the shared uniform block
+    o.frameUniforms.setTarget(projection, resolution);
 }
 
 void Framebuffer::bindTexture()
 {
-    glBindTexture(GL_TEXTURE_2D, texId);
+    GLState::bindTexture(GL_TEXTURE_2D, texId);
+}
+
+GLuint Framebuffer::getTexture() const
+{
+    return texId;
 }
 
 void Framebuffer::scaleResolution(float scale)
@@ -71,12 +78,12 @@ void Framebuffer::scaleResolution(float scale)
         return;
     
     glGenFramebuffers(1, &id);
-    glBindFramebuffer(GL_FRAMEBUFFER, id);
+    GLState::bindFramebuffer(id);
 
     // create color attachment texture
     glGenTextures(1, &texId);
-    glBindTexture(GL_TEXTURE_2D, texId);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, resolution.x, resolution.y, 0, GL_RGB, GL_UNSIGNED_BYTE, nullptr);
+    GLState::bindTexture(GL_TEXTURE_2D, texId);
+    glTexImage2D(GL_TEXTURE_2D, 0, format, resolution.x, resolution.y, 0, format, GL_UNSIGNED_BYTE, nullptr);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
     glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, texId, 0);
@@ -90,5 +97,5 @@ void Framebuffer::scaleResolution(float scale)
     if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
         LOG_ERROR("Framebuffer is not complete!");
     
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    GLState::bindFramebuffer(0);
 }
@@ -20,13 +20,17 @@ class Framebuffer
     GLuint id = 0;
     GLuint texId = 0;
     GLuint rbo = 0;
+
+    GLint format = GL_RGB;
 public:
     Framebuffer() = default;
-    Framebuffer(int width, int height);
+    Framebuffer(int width, int height, GLint _format = GL_RGB);
 
     void bind();
     void bindTexture();
 
+    GLuint getTexture() const;
+
     void scaleResolution(float scale);
 
     glm::ivec2 defaultResolution = glm::ivec2(1920, 1080);
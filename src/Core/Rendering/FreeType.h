@@ -1,17 +1,32 @@
 ﻿#pragma once
 
+#include <algorithm>
+
 #include <ft2build.h>
 #include <Core/File.h>
 
 #include FT_FREETYPE_H
 
 #include "Types.h"
+#include "GLState.h"
 
 class FreeType
 {
     std::vector<unsigned char> fontData;
 
 public:
+    // glyphs are rendered into one atlas so a whole string can be drawn with a single texture
+    static constexpr int ATLAS_WIDTH = 512;
+    static constexpr int GLYPH_PADDING = 2;
+
+    struct GlyphBitmap
+    {
+        char c;
+        int width, rows;
+        std::vector<unsigned char> pixels;
+    };
+    std::vector<GlyphBitmap> glyphBitmaps;
+
     void loadChar(FT_Face face, char c)
     {
         // load character glyph 
@@ -21,10 +36,60 @@ public:
             return;
         }
 
-        // create the texture for this character
+        const FT_Bitmap& bitmap = face->glyph->bitmap;
+
+        // keep the bitmap around until every glyph is rendered and the atlas can be laid out
+        GlyphBitmap glyph = { c, int(bitmap.width), int(bitmap.rows) };
+        glyph.pixels.resize(glyph.width * glyph.rows);
+        for (int row = 0; row < glyph.rows; row++)
+            std::copy_n(bitmap.buffer + row * bitmap.pitch, glyph.width, glyph.pixels.data() + row * glyph.width);
+
+        glyphBitmaps.push_back(std::move(glyph));
+
+        FontCharacter character = {
+            0,
+            glm::vec4(0),
+            glm::ivec2(face->glyph->bitmap.width, face->glyph->bitmap.rows),
+            glm::ivec2(face->glyph->bitmap_left, face->glyph->bitmap_top),
+            face->glyph->advance.x
+        };
+
+        loadedCharacters.insert(std::pair<char, FontCharacter>(c, character));
+    }
+
+    void createAtlas()
+    {
+        // shelf pack the glyphs in the order they were loaded, they're all about the same height
+        int x = 0, y = 0, shelfHeight = 0;
+        std::vector<glm::ivec2> offsets;
+        for (const GlyphBitmap& glyph : glyphBitmaps)
+        {
+            if (x + glyph.width + GLYPH_PADDING > ATLAS_WIDTH)
+            {
+                x = 0;
+                y += shelfHeight;
+                shelfHeight = 0;
+            }
+
+            offsets.emplace_back(x + GLYPH_PADDING, y + GLYPH_PADDING);
+
+            x += glyph.width + GLYPH_PADDING * 2;
+            shelfHeight = std::max(shelfHeight, glyph.rows + GLYPH_PADDING * 2);
+        }
+        const int atlasHeight = y + shelfHeight;
+
+        std::vector<unsigned char> atlas(ATLAS_WIDTH * atlasHeight, 0);
+        for (size_t i = 0; i < glyphBitmaps.size(); i++)
+        {
+            const GlyphBitmap& glyph = glyphBitmaps[i];
+            for (int row = 0; row < glyph.rows; row++)
+                std::copy_n(glyph.pixels.data() + row * glyph.width, glyph.width,
+                            atlas.data() + (offsets[i].y + row) * ATLAS_WIDTH + offsets[i].x);
+        }
+
         unsigned int texture;
         glGenTextures(1, &texture);
-        glBindTexture(GL_TEXTURE_2D, texture);
+        GLState::bindTexture(GL_TEXTURE_2D, texture);
 #ifdef USE_GLFM
         constexpr GLint internalFormat = GL_ALPHA;
 #else
@@ -35,26 +100,31 @@ public:
             GL_TEXTURE_2D,
             0,
             internalFormat,
-            face->glyph->bitmap.width,
-            face->glyph->bitmap.rows,
+            ATLAS_WIDTH,
+            atlasHeight,
             0,
             internalFormat,
             GL_UNSIGNED_BYTE,
-            face->glyph->bitmap.buffer
+            atlas.data()
         );
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
 
-        FontCharacter character = {
-            texture,
-            glm::ivec2(face->glyph->bitmap.width, face->glyph->bitmap.rows),
-            glm::ivec2(face->glyph->bitmap_left, face->glyph->bitmap_top),
-            face->glyph->advance.x
-        };
+        for (size_t i = 0; i < glyphBitmaps.size(); i++)
+        {
+            const GlyphBitmap& glyph = glyphBitmaps[i];
 
-        loadedCharacters.insert(std::pair<char, FontCharacter>(c, character));
+            FontCharacter& character = loadedCharacters[glyph.c];
+            character.textureId = texture;
+            character.uv = glm::vec4(float(offsets[i].x) / ATLAS_WIDTH, float(offsets[i].y) / atlasHeight,
+                                     float(offsets[i].x + glyph.width) / ATLAS_WIDTH, float(offsets[i].y + glyph.rows) / atlasHeight);
+        }
+
+        LOG_INFO("Packed %i glyphs into a %ix%i atlas", int(glyphBitmaps.size()), ATLAS_WIDTH, atlasHeight);
+
+        glyphBitmaps.clear();
     }
 
     FreeType()
@@ -114,6 +184,8 @@ public:
         loadChar(face, '$'); // circle
         loadChar(face, '%'); // square
         loadChar(face, '&'); // triangle
+
+        createAtlas();
     }
 
     std::unordered_map<char, FontCharacter> loadedCharacters;
@@ -0,0 +1,185 @@
+#include "GLState.h"
+
+#include <array>
+
+namespace
+{
+    constexpr GLuint UNKNOWN = ~0u;
+    constexpr int TEXTURE_UNITS = 8;
+
+    struct State
+    {
+        GLuint program = UNKNOWN;
+
+        GLenum activeUnit = UNKNOWN;
+        std::array<GLuint, TEXTURE_UNITS> texture2D;
+        std::array<GLuint, TEXTURE_UNITS> texture2DArray;
+
+        GLuint vao = UNKNOWN;
+        GLuint arrayBuffer = UNKNOWN;
+        GLuint uniformBuffer = UNKNOWN;
+        GLuint framebuffer = UNKNOWN;
+
+        std::array<GLenum, 4> blend = { UNKNOWN, UNKNOWN, UNKNOWN, UNKNOWN };
+
+        State()
+        {
+            texture2D.fill(UNKNOWN);
+            texture2DArray.fill(UNKNOWN);
+        }
+    };
+
+    State state;
+
+    GLState::Stats frameStats;
+    GLState::Stats lastStats;
+
+    // returns true if the call has to be issued
+    template <typename T>
+    bool change(T& cached, const T& value)
+    {
+        if (cached == value)
+        {
+            frameStats.skipped++;
+            return false;
+        }
+
+        cached = value;
+        frameStats.issued++;
+        return true;
+    }
+
+    GLuint* boundTexture(GLenum target)
+    {
+        const GLuint unit = state.activeUnit == UNKNOWN ? 0 : state.activeUnit - GL_TEXTURE0;
+        if (unit >= TEXTURE_UNITS)
+            return nullptr;
+
+        switch (target)
+        {
+            case GL_TEXTURE_2D:
+                return &state.texture2D[unit];
+            case GL_TEXTURE_2D_ARRAY:
+                return &state.texture2DArray[unit];
+            default:
+                return nullptr;
+        }
+    }
+}
+
+void GLState::useProgram(GLuint program)
+{
+    if (change(state.program, program))
+        glUseProgram(program);
+}
+
+void GLState::activeTexture(GLenum unit)
+{
+    if (change(state.activeUnit, unit))
+        glActiveTexture(unit);
+}
+
+void GLState::bindTexture(GLenum target, GLuint texture)
+{
+    // the unit has to be known for the cache to mean anything
+    if (state.activeUnit == UNKNOWN)
+        activeTexture(GL_TEXTURE0);
+
+    GLuint* cached = boundTexture(target);
+    if (cached == nullptr)
+    {
+        frameStats.issued++;
+        glBindTexture(target, texture);
+        return;
+    }
+
+    if (change(*cached, texture))
+        glBindTexture(target, texture);
+}
+
+void GLState::deleteTexture(GLuint texture)
+{
+    glDeleteTextures(1, &texture);
+
+    // GL unbinds deleted textures, and the name may be handed out again
+    for (int unit = 0; unit < TEXTURE_UNITS; unit++)
+    {
+        if (state.texture2D[unit] == texture)
+            state.texture2D[unit] = 0;
+        if (state.texture2DArray[unit] == texture)
+            state.texture2DArray[unit] = 0;
+    }
+}
+
+void GLState::bindVertexArray(GLuint vao)
+{
+    if (change(state.vao, vao))
+        glBindVertexArray(vao);
+}
+
+void GLState::bindBuffer(GLenum target, GLuint buffer)
+{
+    GLuint* cached = nullptr;
+    switch (target)
+    {
+        case GL_ARRAY_BUFFER:
+            cached = &state.arrayBuffer;
+            break;
+        case GL_UNIFORM_BUFFER:
+            cached = &state.uniformBuffer;
+            break;
+    }
+
+    if (cached == nullptr)
+    {
+        frameStats.issued++;
+        glBindBuffer(target, buffer);
+        return;
+    }
+
+    if (change(*cached, buffer))
+        glBindBuffer(target, buffer);
+}
+
+void GLState::bindBufferBase(GLenum target, GLuint index, GLuint buffer)
+{
+    frameStats.issued++;
+    glBindBufferBase(target, index, buffer);
+
+    // indexed bindings aren't cached, but GL binds the buffer to the generic target as well
+    if (target == GL_UNIFORM_BUFFER)
+        state.uniformBuffer = buffer;
+}
+
+void GLState::bindFramebuffer(GLuint framebuffer)
+{
+    if (change(state.framebuffer, framebuffer))
+        glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+}
+
+void GLState::blendFunc(GLenum src, GLenum dst)
+{
+    blendFuncSeparate(src, dst, src, dst);
+}
+
+void GLState::blendFuncSeparate(GLenum srcRGB, GLenum dstRGB, GLenum srcAlpha, GLenum dstAlpha)
+{
+    if (change(state.blend, std::array<GLenum, 4>{ srcRGB, dstRGB, srcAlpha, dstAlpha }))
+        glBlendFuncSeparate(srcRGB, dstRGB, srcAlpha, dstAlpha);
+}
+
+void GLState::invalidate()
+{
+    state = State();
+}
+
+void GLState::endFrame()
+{
+    lastStats = frameStats;
+    frameStats = Stats();
+}
+
+const GLState::Stats& GLState::lastFrameStats()
+{
+    return lastStats;
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#ifdef USE_GLFM
+#include "glfm.h"
+#else
+#include <glad/glad.h>
+#endif
+
+// Thin cache in front of the GL binding calls. Every bind that already matches the current state is skipped.
+// All rendering code should go through here, or call invalidate() after touching GL state directly.
+namespace GLState
+{
+    void useProgram(GLuint program);
+
+    void activeTexture(GLenum unit);
+    void bindTexture(GLenum target, GLuint texture); // on the active unit
+    void deleteTexture(GLuint texture);
+
+    void bindVertexArray(GLuint vao);
+    void bindBuffer(GLenum target, GLuint buffer); // element array bindings are VAO state and go straight through
+    void bindBufferBase(GLenum target, GLuint index, GLuint buffer); // always issued, it also binds target
+    void bindFramebuffer(GLuint framebuffer);
+
+    void blendFunc(GLenum src, GLenum dst);
+    void blendFuncSeparate(GLenum srcRGB, GLenum dstRGB, GLenum srcAlpha, GLenum dstAlpha);
+
+    // forget everything we know, the next call of each kind will be issued
+    void invalidate();
+
+    struct Stats
+    {
+        unsigned int issued = 0;
+        unsigned int skipped = 0;
+    };
+
+    // call once after the frame is presented to reset the per-frame counters
+    void endFrame();
+
+    const Stats& lastFrameStats();
+}
@@ -10,6 +10,7 @@
 #include "Constants.h"
 #include "Util.h"
 #include "Framebuffer.h"
+#include "GLState.h"
 
 class OpenGL
 {
@@ -94,7 +95,7 @@ public:
 
         // GL Settings
         glEnable(GL_BLEND);
-        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        GLState::blendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
         glDisable(GL_DEPTH_TEST);
 
         // init framebuffer
@@ -115,8 +116,8 @@ public:
         GLuint quadVBO;
         glGenVertexArrays(1, &crtVAO);
         glGenBuffers(1, &quadVBO);
-        glBindVertexArray(crtVAO);
-        glBindBuffer(GL_ARRAY_BUFFER, quadVBO);
+        GLState::bindVertexArray(crtVAO);
+        GLState::bindBuffer(GL_ARRAY_BUFFER, quadVBO);
         glBufferData(GL_ARRAY_BUFFER, sizeof(quadVertices), &quadVertices, GL_STATIC_DRAW);
         glEnableVertexAttribArray(0);
         glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), nullptr);
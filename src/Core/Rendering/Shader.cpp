@@ -1,12 +1,16 @@
 #include "Shader.h"
 #include "Core.h"
 
+#include <cstring>
+#include <filesystem>
 #include <fstream>
 
 #include <ext/matrix_clip_space.hpp>
 
 #include "Util.h"
 #include "Core/File.h"
+#include "FrameUniforms.h"
+#include "GLState.h"
 
 Shader::Shader(const GLchar* vertexName, const GLchar* fragmentName)
 {
@@ -31,6 +35,33 @@ Shader::Shader(const GLchar* vertexName, const GLchar* fragmentName)
     std::string vCodeStr = std::string(vCodeVector.begin(), vCodeVector.end());
     std::string fCodeStr = std::string(fCodeVector.begin(), fCodeVector.end());
 
+    const std::string cachePath = "shadercache/" + vName + "_" + fName + ".bin";
+    const uint64_t sourceHash = hashSources(vCodeStr, fCodeStr);
+
+    ID = glCreateProgram();
+
+    if (loadProgramBinary(cachePath, sourceHash))
+    {
+        loadedFromCache = true;
+    }
+    else
+    {
+        compileAndLink(vCodeStr, fCodeStr, vertexFile.path(), fragmentFile.path());
+        saveProgramBinary(cachePath, sourceHash);
+    }
+
+    resolveUniforms();
+
+    // hook up the shared per-frame uniforms, if this program uses them
+    const GLuint frameBlock = glGetUniformBlockIndex(ID, FrameUniforms::BLOCK_NAME);
+    if (frameBlock != GL_INVALID_INDEX)
+        glUniformBlockBinding(ID, frameBlock, FrameUniforms::BINDING);
+
+}
+
+void Shader::compileAndLink(const std::string& vCodeStr, const std::string& fCodeStr,
+                            const std::string& vertexPath, const std::string& fragmentPath)
+{
     const char* vCode = vCodeStr.c_str();
     const char* fCode = fCodeStr.c_str();
 
@@ -46,7 +77,7 @@ Shader::Shader(const GLchar* vertexName, const GLchar* fragmentName)
     if (!success)
     {
         glGetShaderInfoLog(vertex, 512, nullptr, errorLog);
-        LOG_ERROR("Vertex shader %s failed to compile, error log:\n%s", vertexFile.path(), errorLog);
+        LOG_ERROR("Vertex shader %s failed to compile, error log:\n%s", vertexPath, errorLog);
         LOG("Vertex shader code: \n\n%s\n\n", std::string(vCode));
     }
 
@@ -59,33 +90,240 @@ Shader::Shader(const GLchar* vertexName, const GLchar* fragmentName)
     if (!success)
     {
         glGetShaderInfoLog(fragment, 512, nullptr, errorLog);
-        LOG_ERROR("Fragment shader %s failed to compile, error log:\n%s", fragmentFile.path(), errorLog);
+        LOG_ERROR("Fragment shader %s failed to compile, error log:\n%s", fragmentPath, errorLog);
         LOG("Fragment shader code: \n\n%s\n\n", std::string(fCode));
     }
 
     // shader program
-    ID = glCreateProgram();
     glAttachShader(ID, vertex);
     glAttachShader(ID, fragment);
 
+    if (programBinariesSupported())
+        glProgramParameteri(ID, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+
     glLinkProgram(ID);
     // print linking errors if any
     glGetProgramiv(ID, GL_LINK_STATUS, &success);
     if (!success)
     {
         glGetProgramInfoLog(ID, 512, nullptr, errorLog);
-        LOG_ERROR("Failed to link shader programs %s and %s, error log:\n%s", vertexFile.path(), fragmentFile.path(), errorLog);
+        LOG_ERROR("Failed to link shader programs %s and %s, error log:\n%s", vertexPath, fragmentPath, errorLog);
     }
 
     // delete the shaders as they're linked into our program now and no longer necessary
+    glDetachShader(ID, vertex);
+    glDetachShader(ID, fragment);
     glDeleteShader(vertex);
     glDeleteShader(fragment);
 }
 
+namespace
+{
+    // header of a file in the program binary cache. Followed by the driver string and the binary itself
+    struct BinaryHeader
+    {
+        char magic[4] = { 'R', 'A', 'S', 'B' };
+        uint32_t version = 1;
+        uint64_t sourceHash = 0;
+        uint32_t driverLength = 0;
+        uint32_t binaryFormat = 0;
+        uint32_t binaryLength = 0;
+    };
+
+    // binaries are only valid for the exact driver that produced them
+    std::string driverString()
+    {
+        const auto str = [](GLenum name) {
+            const GLubyte* value = glGetString(name);
+            return value ? std::string((const char*) value) : std::string();
+        };
+
+        return str(GL_VENDOR) + "|" + str(GL_RENDERER) + "|" + str(GL_VERSION);
+    }
+}
+
+bool Shader::programBinariesSupported()
+{
+#if defined(PLATFORM_EMSCRIPTEN) || defined(PLATFORM_ANDROID)
+    return false; // WebGL has no program binaries, and Android has nowhere we write to yet
+#else
+    static const bool supported = [] {
+        if (!GLAD_GL_ARB_get_program_binary || !glGetProgramBinary || !glProgramBinary || !glProgramParameteri)
+            return false;
+
+        GLint formats = 0;
+        glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+        return formats > 0;
+    }();
+
+    return supported;
+#endif
+}
+
+// FNV-1a over both sources. 64 bits so a stale binary is never mistaken for a fresh one
+uint64_t Shader::hashSources(const std::string& vCode, const std::string& fCode)
+{
+    uint64_t hash = 14695981039346656037ull;
+    const auto add = [&hash](const std::string& str) {
+        for (unsigned char c : str)
+        {
+            hash ^= c;
+            hash *= 1099511628211ull;
+        }
+
+        // separator, so moving code between the stages changes the hash
+        hash ^= 0xFF;
+        hash *= 1099511628211ull;
+    };
+
+    add(vCode);
+    add(fCode);
+
+    return hash;
+}
+
+bool Shader::loadProgramBinary(const std::string& path, uint64_t sourceHash)
+{
+    if (!programBinariesSupported())
+        return false;
+
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+        return false;
+
+    BinaryHeader header;
+    file.read((char*) &header, sizeof(header));
+
+    const std::string driver = driverString();
+    if (!file || std::memcmp(header.magic, BinaryHeader().magic, 4) != 0 || header.version != BinaryHeader().version ||
+        header.sourceHash != sourceHash || header.driverLength != driver.size())
+    {
+        LOG_INFO("Shader binary %s is out of date, recompiling", path);
+        return false;
+    }
+
+    std::string cachedDriver(header.driverLength, '\0');
+    file.read(cachedDriver.data(), header.driverLength);
+
+    std::vector<char> binary(header.binaryLength);
+    file.read(binary.data(), header.binaryLength);
+
+    if (!file || cachedDriver != driver)
+    {
+        LOG_INFO("Shader binary %s was made by another driver, recompiling", path);
+        return false;
+    }
+
+    glProgramBinary(ID, header.binaryFormat, binary.data(), GLsizei(binary.size()));
+
+    // drivers may reject binaries for reasons of their own, e.g. after an update that kept the version string
+    GLint success = 0;
+    glGetProgramiv(ID, GL_LINK_STATUS, &success);
+    if (!success)
+    {
+        LOG_INFO("Driver rejected shader binary %s, recompiling", path);
+        return false;
+    }
+
+    return true;
+}
+
+void Shader::saveProgramBinary(const std::string& path, uint64_t sourceHash) const
+{
+    if (!programBinariesSupported())
+        return;
+
+    GLint success = 0;
+    glGetProgramiv(ID, GL_LINK_STATUS, &success);
+    if (!success)
+        return; // don't cache broken programs
+
+    GLint length = 0;
+    glGetProgramiv(ID, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0)
+        return;
+
+    std::vector<char> binary(length);
+    GLenum format = 0;
+    glGetProgramBinary(ID, length, &length, &format, binary.data());
+
+    if (Util::glError())
+    {
+        LOG_ERROR("Failed to retrieve the binary of %s", path);
+        return;
+    }
+
+    const std::string driver = driverString();
+
+    BinaryHeader header;
+    header.sourceHash = sourceHash;
+    header.driverLength = driver.size();
+    header.binaryFormat = format;
+    header.binaryLength = length;
+
+    std::error_code error;
+    std::filesystem::create_directories(std::filesystem::path(path).parent_path(), error);
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write((const char*) &header, sizeof(header));
+    file.write(driver.data(), driver.size());
+    file.write(binary.data(), length);
+
+    if (!file)
+    {
+        LOG_ERROR("Failed to write shader binary %s", path);
+    }
+}
+
 // use/activate the shader
 void Shader::use() const
 {
-    glUseProgram(ID);
+    GLState::useProgram(ID);
+}
+
+void Shader::setBool(Uniform uniform, bool value) const
+{
+    glUniform1i(getUniformLocation(uniform), int(value));
+}
+
+void Shader::setInt(Uniform uniform, int value) const
+{
+    glUniform1i(getUniformLocation(uniform), value);
+}
+
+void Shader::setFloat(Uniform uniform, float value) const
+{
+    glUniform1f(getUniformLocation(uniform), value);
+}
+
+void Shader::setVec2(Uniform uniform, const glm::vec2& value) const
+{
+    glUniform2fv(getUniformLocation(uniform), 1, &value[0]);
+}
+
+void Shader::setVec3(Uniform uniform, const glm::vec3& value) const
+{
+    glUniform3fv(getUniformLocation(uniform), 1, &value[0]);
+}
+
+void Shader::setVec4(Uniform uniform, const glm::vec4& value) const
+{
+    glUniform4fv(getUniformLocation(uniform), 1, &value[0]);
+}
+
+void Shader::setMat2(Uniform uniform, const glm::mat2& mat) const
+{
+    glUniformMatrix2fv(getUniformLocation(uniform), 1, GL_FALSE, &mat[0][0]);
+}
+
+void Shader::setMat3(Uniform uniform, const glm::mat3& mat) const
+{
+    glUniformMatrix3fv(getUniformLocation(uniform), 1, GL_FALSE, &mat[0][0]);
+}
+
+void Shader::setMat4(Uniform uniform, const glm::mat4& mat) const
+{
+    glUniformMatrix4fv(getUniformLocation(uniform), 1, GL_FALSE, &mat[0][0]);
 }
 
 // utility uniform functions
@@ -157,27 +395,81 @@ void Shader::setMat4(const char* name, const glm::mat4& mat) const
     glUniformMatrix4fv(getUniformLocation(name), 1, GL_FALSE, &mat[0][0]);
 }
 
-GLint Shader::getUniformLocation(const char* uniformName) const
+void Shader::resolveUniforms()
 {
-    std::size_t hash = Util::hashBytes(uniformName, strlen(uniformName));
+    uniformCount = 0;
+    overflowUniforms.clear();
 
-    const auto f = uniformCache.find(hash);
+    GLint activeUniforms = 0;
+    glGetProgramiv(ID, GL_ACTIVE_UNIFORMS, &activeUniforms);
 
-    GLint loc;
+    for (GLint i = 0; i < activeUniforms; i++)
+    {
+        GLchar name[64];
+        GLsizei length = 0;
+        GLint size = 0;
+        GLenum type = 0;
+        glGetActiveUniform(ID, GLuint(i), sizeof(name), &length, &size, &type, name);
+
+        // members of uniform blocks have no location
+        const GLint location = glGetUniformLocation(ID, name);
+        if (location == -1)
+            continue;
+
+        if (uniformCount == MAX_UNIFORMS)
+        {
+            LOG_ERROR("Shader %i has more than %i uniforms, %s will be looked up by name", ID, MAX_UNIFORMS, std::string(name));
+            continue;
+        }
+
+        uniforms[uniformCount++] = { Util::hashBytes(name, length), location, std::string(name, length) };
+    }
+}
 
-    if (f == uniformCache.end())
+GLint Shader::getUniformLocation(Uniform uniform) const
+{
+    for (int i = 0; i < uniformCount; i++)
     {
-        // get uniform location
-        loc = glGetUniformLocation(ID, uniformName);
+        const UniformSlot& slot = uniforms[i];
+        if (slot.hash != uniform.hash)
+            continue;
 
-        std::pair<std::size_t, GLuint> newLoc(hash, loc);
-        uniformCache.insert(newLoc);
+        // handles wrap string literals, so once one matched by name its pointer is all we compare
+        if (slot.handleName == uniform.name)
+            return slot.location;
+
+        if (slot.name == uniform.name)
+        {
+            slot.handleName = uniform.name;
+            return slot.location;
+        }
     }
-    else
+
+    return overflowLocation(uniform.name);
+}
+
+GLint Shader::getUniformLocation(const char* uniformName) const
+{
+    // the name may not outlive this call, so it's compared as a string every time
+    const std::size_t hash = Util::hashBytes(uniformName, strlen(uniformName));
+    for (int i = 0; i < uniformCount; i++)
     {
-        loc = (*f).second;
+        if (uniforms[i].hash == hash && uniforms[i].name == uniformName)
+            return uniforms[i].location;
     }
 
+    return overflowLocation(uniformName);
+}
+
+GLint Shader::overflowLocation(const char* uniformName) const
+{
+    // didn't fit in the table, or isn't an active uniform. GL ignores writes to -1
+    const auto f = overflowUniforms.find(uniformName);
+    if (f != overflowUniforms.end())
+        return f->second;
+
+    const GLint loc = glGetUniformLocation(ID, uniformName);
+    overflowUniforms.emplace(uniformName, loc);
     return loc;
 }
 
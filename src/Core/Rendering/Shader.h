@@ -1,7 +1,8 @@
 #pragma once
 
-#include <unordered_map>
+#include <array>
 #include <string>
+#include <unordered_map>
 
 #ifdef USE_GLFM
 #include "glfm.h"
@@ -11,6 +12,8 @@
 
 #include <glm.hpp>
 
+#include "Util.h"
+
 class Camera;
 
 class Shader
@@ -19,6 +22,9 @@ public:
     // the shader program's ID
     GLuint ID = 0;
 
+    // true if the program came out of the on-disk binary cache instead of being compiled
+    bool loadedFromCache = false;
+
     Shader() = default;
 
     // constructor reads and builds the shader
@@ -27,7 +33,30 @@ public:
     // activate the shader
     void use() const;
 
-    // utility uniform functions
+    // Handle to a uniform by name. Declare them constexpr so the name is hashed at compile time:
+    //     static constexpr Shader::Uniform opacity("opacity");
+    // The name has to be a string literal, lookups remember its address
+    struct Uniform
+    {
+        constexpr explicit Uniform(const char* name)
+            : hash(Util::hashBytes(name, std::char_traits<char>::length(name))), name(name) {}
+
+        std::size_t hash;
+        const char* name;
+    };
+
+    // fast path, the location is looked up in the table filled after linking
+    void setBool(Uniform uniform, bool value) const;
+    void setInt(Uniform uniform, int value) const;
+    void setFloat(Uniform uniform, float value) const;
+    void setVec2(Uniform uniform, const glm::vec2& value) const;
+    void setVec3(Uniform uniform, const glm::vec3& value) const;
+    void setVec4(Uniform uniform, const glm::vec4& value) const;
+    void setMat2(Uniform uniform, const glm::mat2& mat) const;
+    void setMat3(Uniform uniform, const glm::mat3& mat) const;
+    void setMat4(Uniform uniform, const glm::mat4& mat) const;
+
+    // utility uniform functions. These hash the name on every call, prefer the Uniform overloads in hot code
     void setBool(const char* name, bool value) const;
     // ------------------------------------------------------------------------
     void setInt(const char* name, int value) const;
@@ -50,10 +79,38 @@ public:
     void setMat4(const char* name, const glm::mat4& mat) const;
 
 private:
+    void compileAndLink(const std::string& vCode, const std::string& fCode,
+                        const std::string& vertexPath, const std::string& fragmentPath);
+
+    // linked programs are cached in shadercache/, keyed by the source hash and the driver that built them
+    static bool programBinariesSupported();
+    static uint64_t hashSources(const std::string& vCode, const std::string& fCode);
+    bool loadProgramBinary(const std::string& path, uint64_t sourceHash);
+    void saveProgramBinary(const std::string& path, uint64_t sourceHash) const;
+
     // utility function for checking shader compilation/linking errors.
     static void checkCompileErrors(GLuint shader, const std::string& type);
 
+    // fills the uniform table with every active uniform of the linked program
+    void resolveUniforms();
+
+    GLint getUniformLocation(Uniform uniform) const;
     GLint getUniformLocation(const char* uniformName) const;
+    GLint overflowLocation(const char* uniformName) const;
+
+    static constexpr int MAX_UNIFORMS = 16;
+
+    struct UniformSlot
+    {
+        std::size_t hash = 0;
+        GLint location = -1;
+        std::string name; // hashes can collide, the name has the final say
+        mutable const char* handleName = nullptr; // the name of the last handle that matched
+    };
+
+    std::array<UniformSlot, MAX_UNIFORMS> uniforms;
+    int uniformCount = 0;
 
-    mutable std::unordered_map<size_t, GLint> uniformCache;
+    // uniforms that didn't fit in the table or aren't active, so GL is only asked once per name
+    mutable std::unordered_map<std::string, GLint> overflowUniforms;
 };
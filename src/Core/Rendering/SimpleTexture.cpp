@@ -1,13 +1,29 @@
 #include "SimpleTexture.h"
 
+#include "GLState.h"
+
 SimpleTexture::SimpleTexture(const GLuint& _texId)
 {
     texId = _texId;
 }
 
+SimpleTexture::SimpleTexture(const TextureRegion& region)
+{
+    texId = region.texId;
+    uv = region.uv;
+}
+
 void SimpleTexture::bind() const
 {
-    glBindTexture(GL_TEXTURE_2D, texId);
+    GLState::bindTexture(GL_TEXTURE_2D, texId);
+}
+
+glm::vec4 SimpleTexture::getUV(bool flip) const
+{
+    if (flip)
+        return glm::vec4(uv.z, uv.y, uv.x, uv.w);
+
+    return uv;
 }
 
 void SimpleTexture::tick()
@@ -18,7 +34,12 @@ void SimpleTexture::reset()
 {
 }
 
+bool SimpleTexture::finished() const
+{
+    return true;
+}
+
 bool SimpleTexture::operator==(const SimpleTexture& st) const
 {
-    return texId == st.texId;
+    return texId == st.texId && uv == st.uv;
 }
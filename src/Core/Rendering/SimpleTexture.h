@@ -8,21 +8,39 @@
 #include <glad/glad.h>
 #endif
 
+#include <glm.hpp>
+
+// A texture, or a region of one. Atlas regions share their texId with other textures.
+struct TextureRegion
+{
+    GLuint texId = 0;
+    glm::vec4 uv = glm::vec4(0, 0, 1, 1); // left, top, right, bottom
+};
+
 class SimpleTexture
 {
 public:
     SimpleTexture() = default;
     SimpleTexture(const GLuint& _texId);
+    SimpleTexture(const TextureRegion& region);
 
     void bind() const;
 
+    // uv rect of this texture inside texId, mirrored horizontally if flip is set
+    glm::vec4 getUV(bool flip = false) const;
+
     virtual void tick();
 
     virtual void reset();
+
+    // true once an animation has shown its last frame. Still textures always are, looping ones never
+    virtual bool finished() const;
+
     bool shouldTick = false;
     bool loop = true;
 
     GLuint texId = 0;
+    glm::vec4 uv = glm::vec4(0, 0, 1, 1);
 
     bool operator==(const SimpleTexture& st) const;
 
@@ -0,0 +1,169 @@
+#include "SpriteBatch.h"
+
+#include <algorithm>
+#include <cstddef>
+
+#include "GLState.h"
+#include "Shader.h"
+
+SpriteBatch::SpriteBatch()
+{
+    glGenVertexArrays(1, &m_vao);
+    glGenBuffers(1, &m_vbo);
+    glGenBuffers(1, &m_ebo);
+
+    GLState::bindVertexArray(m_vao);
+    GLState::bindBuffer(GL_ARRAY_BUFFER, m_vbo);
+
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(SpriteVertex), (void*) offsetof(SpriteVertex, pos));
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(SpriteVertex), (void*) offsetof(SpriteVertex, texCoords));
+    glEnableVertexAttribArray(2);
+    glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, sizeof(SpriteVertex), (void*) offsetof(SpriteVertex, color));
+
+    // the element buffer binding is part of the VAO state
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_ebo);
+    ensureIndexCapacity(1024);
+
+    GLState::bindVertexArray(0);
+    GLState::bindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void SpriteBatch::submit(const Shader& shader, GLuint texture, const glm::vec2& pos, const glm::vec2& size,
+                         const glm::vec4& uv, const glm::vec4& color)
+{
+    const glm::vec2 quadMin = pos;
+    const glm::vec2 quadMax = pos + size;
+
+    // find a batch we can join without changing what ends up on screen
+    Batch* target = nullptr;
+    const int lookbackEnd = std::max(0, int(m_batchCount) - MAX_LOOKBACK);
+    for (int i = int(m_batchCount) - 1; i >= lookbackEnd; i--)
+    {
+        Batch& batch = m_batches[i];
+
+        if (batch.program == shader.ID && batch.texture == texture)
+        {
+            target = &batch;
+            break;
+        }
+
+        // this batch is drawn after any earlier one, so we can't jump over it if we'd be covered
+        const bool overlaps = quadMin.x < batch.max.x && quadMax.x > batch.min.x &&
+                              quadMin.y < batch.max.y && quadMax.y > batch.min.y;
+        if (overlaps)
+            break;
+    }
+
+    if (target == nullptr)
+    {
+        if (m_batchCount == m_batches.size())
+            m_batches.emplace_back();
+
+        target = &m_batches[m_batchCount++];
+        target->program = shader.ID;
+        target->texture = texture;
+        target->min = quadMin;
+        target->max = quadMax;
+        target->vertices.clear();
+    }
+    else
+    {
+        target->min = glm::min(target->min, quadMin);
+        target->max = glm::max(target->max, quadMax);
+    }
+
+    target->vertices.push_back({ { quadMin.x, quadMin.y }, { uv.x, uv.y }, color });
+    target->vertices.push_back({ { quadMax.x, quadMin.y }, { uv.z, uv.y }, color });
+    target->vertices.push_back({ { quadMax.x, quadMax.y }, { uv.z, uv.w }, color });
+    target->vertices.push_back({ { quadMin.x, quadMax.y }, { uv.x, uv.w }, color });
+
+    m_quadCount++;
+    m_frameStats.sprites++;
+}
+
+void SpriteBatch::flush()
+{
+    if (m_batchCount == 0)
+        return;
+
+    // lay all batches out back to back in one buffer
+    m_uploadBuffer.clear();
+    for (unsigned int i = 0; i < m_batchCount; i++)
+    {
+        const auto& vertices = m_batches[i].vertices;
+        m_uploadBuffer.insert(m_uploadBuffer.end(), vertices.begin(), vertices.end());
+    }
+
+    GLState::bindVertexArray(m_vao);
+    ensureIndexCapacity(m_quadCount);
+
+    // orphan the old storage so we don't stall on draws that still read it
+    GLState::bindBuffer(GL_ARRAY_BUFFER, m_vbo);
+    const GLsizeiptr uploadSize = GLsizeiptr(m_uploadBuffer.size() * sizeof(SpriteVertex));
+    glBufferData(GL_ARRAY_BUFFER, uploadSize, nullptr, GL_STREAM_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, uploadSize, m_uploadBuffer.data());
+
+    GLState::activeTexture(GL_TEXTURE0);
+
+    unsigned int firstQuad = 0;
+    for (unsigned int i = 0; i < m_batchCount; i++)
+    {
+        const Batch& batch = m_batches[i];
+        const unsigned int quadCount = batch.vertices.size() / 4;
+
+        GLState::useProgram(batch.program);
+        GLState::bindTexture(GL_TEXTURE_2D, batch.texture);
+
+        glDrawElements(GL_TRIANGLES, GLsizei(quadCount * 6), GL_UNSIGNED_INT,
+                       (void*) (firstQuad * 6 * sizeof(GLuint)));
+        m_frameStats.drawCalls++;
+
+        firstQuad += quadCount;
+    }
+
+    m_batchCount = 0;
+    m_quadCount = 0;
+    m_frameStats.flushes++;
+}
+
+void SpriteBatch::endFrame()
+{
+    m_lastFrameStats = m_frameStats;
+    m_frameStats = Stats();
+}
+
+const SpriteBatch::Stats& SpriteBatch::lastFrameStats() const
+{
+    return m_lastFrameStats;
+}
+
+// expects our VAO to be bound
+void SpriteBatch::ensureIndexCapacity(unsigned int quadCount)
+{
+    if (quadCount <= m_indexCapacity)
+        return;
+
+    unsigned int newCapacity = std::max(m_indexCapacity, 1024u);
+    while (newCapacity < quadCount)
+        newCapacity *= 2;
+
+    // every quad is two triangles over its four vertices
+    std::vector<GLuint> indices(newCapacity * 6);
+    for (unsigned int i = 0; i < newCapacity; i++)
+    {
+        const GLuint v = i * 4;
+
+        indices[i * 6 + 0] = v + 0;
+        indices[i * 6 + 1] = v + 1;
+        indices[i * 6 + 2] = v + 2;
+
+        indices[i * 6 + 3] = v + 0;
+        indices[i * 6 + 4] = v + 2;
+        indices[i * 6 + 5] = v + 3;
+    }
+
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, GLsizeiptr(indices.size() * sizeof(GLuint)), indices.data(), GL_STATIC_DRAW);
+    m_indexCapacity = newCapacity;
+}
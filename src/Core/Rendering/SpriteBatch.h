@@ -0,0 +1,85 @@
+#pragma once
+
+#include <vector>
+
+#ifdef USE_GLFM
+#include "glfm.h"
+#else
+#include <glad/glad.h>
+#endif
+
+#include <glm.hpp>
+
+#include "Core.h"
+
+class Shader;
+
+struct SpriteVertex
+{
+    glm::vec2 pos;
+    glm::vec2 texCoords;
+    glm::vec4 color;
+};
+
+// Collects textured quads for the whole frame and draws them with as few draw calls as possible.
+// Quads sharing a shader and texture are merged into one batch, but a quad is only moved in front
+// of other batches if it doesn't overlap them, so the blended result matches drawing in order.
+class SpriteBatch
+{
+public:
+    SpriteBatch();
+
+    // uv is (left, top, right, bottom) in texture space. Swap left and right to flip a sprite.
+    void submit(const Shader& shader, GLuint texture, const glm::vec2& pos, const glm::vec2& size,
+                const glm::vec4& uv = glm::vec4(0, 0, 1, 1), const glm::vec4& color = glm::vec4(1));
+
+    // draw everything submitted so far. Must be called before touching GL state the batch depends on
+    void flush();
+
+    // call once after the frame is presented to reset the per-frame counters
+    void endFrame();
+
+    struct Stats
+    {
+        unsigned int drawCalls = 0;
+        unsigned int sprites = 0;
+        unsigned int flushes = 0;
+    };
+
+    // counters of the last finished frame
+    const Stats& lastFrameStats() const;
+
+    DISALLOW_COPY_AND_ASSIGN(SpriteBatch);
+private:
+    struct Batch
+    {
+        GLuint program = 0;
+        GLuint texture = 0;
+
+        // screen-space bounds of every quad in the batch, used for the overlap test
+        glm::vec2 min = glm::vec2(0);
+        glm::vec2 max = glm::vec2(0);
+
+        std::vector<SpriteVertex> vertices;
+    };
+
+    // how many batches back we look for a compatible one before starting a new batch
+    static constexpr int MAX_LOOKBACK = 16;
+
+    void ensureIndexCapacity(unsigned int quadCount);
+
+    // batches are reused between flushes so their vertex storage keeps its capacity
+    std::vector<Batch> m_batches;
+    unsigned int m_batchCount = 0;
+    unsigned int m_quadCount = 0;
+
+    std::vector<SpriteVertex> m_uploadBuffer;
+
+    GLuint m_vao = 0;
+    GLuint m_vbo = 0;
+    GLuint m_ebo = 0;
+    unsigned int m_indexCapacity = 0; // in quads
+
+    Stats m_frameStats;
+    Stats m_lastFrameStats;
+};
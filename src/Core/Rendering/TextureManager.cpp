@@ -1,10 +1,14 @@
 #include "TextureManager.h"
 
 #include <External/stb_image.h>
+#include <algorithm>
+#include <cstring>
 #include <string>
 
+#include "Outrospection.h"
 #include "Util.h"
 #include "Core/File.h"
+#include "Core/Rendering/GLState.h"
 #include "Core/Rendering/TickableTexture.h"
 
 SimpleTexture TextureManager::MissingTexture(-1);
@@ -38,6 +42,8 @@ TextureManager::TextureManager()
     createTexture(texId, noneTexData, GL_RGBA, 2, 2, GL_NEAREST);
 
     None.texId = texId;
+
+    loadAtlasManifest();
 }
 
 SimpleTexture& TextureManager::loadTexture(const Resource& res, const GLint& filter)
@@ -45,11 +51,11 @@ SimpleTexture& TextureManager::loadTexture(const Resource& res, const GLint& fil
     Resource r = res;
     r.setExtension("png");
 
-    const GLuint texId = textureFromFile(r, filter);
+    const TextureRegion region = textureFromFile(r, filter);
 
-    if (texId != INT_MAX)
+    if (region.texId != INT_MAX)
     {
-        SimpleTexture texObj(texId);
+        SimpleTexture texObj(region);
 
         textures.insert(std::pair(r, std::make_unique<SimpleTexture>(texObj)));
 
@@ -69,29 +75,29 @@ SimpleTexture& TextureManager::loadAnimatedTexture(const Resource& res, unsigned
     Resource r = res;
     r.setExtension("png");
 
-    std::vector<GLuint> textureIds;
+    std::vector<TextureRegion> frames;
 
     for (unsigned int i = 0; i < textureFrameCount; i++)
     {
         Resource curRes = r.getNth(i);
 
-        GLuint currentTextureId = textureFromFile(curRes, filter);
+        TextureRegion currentFrame = textureFromFile(curRes, filter);
 
-        if (currentTextureId != INT_MAX)
+        if (currentFrame.texId != INT_MAX)
         {
-            textureIds.push_back(currentTextureId);
+            frames.push_back(currentFrame);
         }
         else
         {
             LOG_ERROR("Failed to generate texture ID for animated texture frame %i at %s", textureFrameCount,
                       curRes.getPath());
 
-            textureIds.push_back(MissingTexture.texId);
+            frames.push_back({ MissingTexture.texId });
         }
     }
 
     auto [it, success] = textures.insert(
-        std::pair(r, std::make_unique<TickableTexture>(textureIds, textureTickLength, loop)));
+        std::pair(r, std::make_unique<TickableTexture>(frames, textureTickLength, loop)));
 
     return *(it->second);
 }
@@ -137,13 +143,17 @@ void TextureManager::tickAllTextures()
     }
 }
 
-TextureManager::Image TextureManager::readImageBytes(const Resource& res)
+TextureManager::Image TextureManager::readImageBytes(const Resource& res, int components)
 {
     File file = File(res);
     const std::vector<unsigned char> data = file.readAllBytes();
 
     Image ret = Image{res};
-    ret.bytes = stbi_load_from_memory(data.data(), int(data.size()), &ret.width, &ret.height, &ret.nrComponents, 0);
+    ret.bytes = stbi_load_from_memory(data.data(), int(data.size()), &ret.width, &ret.height, &ret.nrComponents, components);
+
+    // stb reports the file's channels, not the ones it converted to
+    if (components != 0)
+        ret.nrComponents = components;
 
     assert(ret.bytes);
 
@@ -158,7 +168,7 @@ void TextureManager::free(unsigned char* data)
 void TextureManager::createTexture(const GLuint& texId, const unsigned char* data, const GLint& format,
                                    const GLsizei& width, const GLsizei& height, const GLint& filter)
 {
-    glBindTexture(GL_TEXTURE_2D, texId);
+    GLState::bindTexture(GL_TEXTURE_2D, texId);
     glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
     
     // TODO make this an option
@@ -170,33 +180,17 @@ void TextureManager::createTexture(const GLuint& texId, const unsigned char* dat
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, filter);
 }
 
-GLuint TextureManager::textureFromFile(const Resource& res, const GLint& filter)
+TextureRegion TextureManager::textureFromFile(const Resource& res, const GLint& filter)
 {
-    GLuint tex;
-    glGenTextures(1, &tex);
-
-    Image image = readImageBytes(res);
+    Image image = readImageBytes(res, componentsFor(res));
 
     if (image.bytes)
     {
-        GLint format;
-        switch(image.nrComponents) {
-            case 1:
-                format = GL_RED;
-                break;
-            case 3:
-                format = GL_RGB;
-                break;
-            case 4:
-                format = GL_RGBA;
-                break;
-        }
-
-        createTexture(tex, image.bytes, format, image.width, image.height, filter);
+        const TextureRegion region = uploadImage(image, filter);
 
         stbi_image_free(image.bytes);
 
-        return tex;
+        return region;
     }
     else
     {
@@ -204,93 +198,218 @@ GLuint TextureManager::textureFromFile(const Resource& res, const GLint& filter)
         LOG_ERROR("stbi_failure_reason: %s", stbi_failure_reason());
         stbi_image_free(image.bytes);
 
-        return INT_MAX;
+        return { INT_MAX };
     }
 }
 
-#include <future>
+TextureRegion TextureManager::uploadImage(const Image& image, const GLint& filter)
+{
+    TextureRegion region;
+    if (uploadToAtlas(image, filter, region))
+        return region;
 
-void TextureManager::requestTexture(const WantedTexture& tex)
+    glGenTextures(1, &region.texId);
+    createTexture(region.texId, image.bytes, formatFor(image.nrComponents), image.width, image.height, filter);
+
+    return region;
+}
+
+bool TextureManager::uploadToAtlas(const Image& image, const GLint& filter, TextureRegion& region)
 {
-#ifdef PLATFORM_EMSCRIPTEN
-    wantedTextures.push_back([tex] {
-#else
-    wantedTextures.emplace_back(std::async(std::launch::async, [tex] {
-#endif
-        WantedTexture ret = tex;
-
-        ret.data = new Image[ret.frameCount];
-
-        // TODO async this, too
-        for (int i = 0; i < ret.frameCount; i++) {
-            Resource curRes;
-            if (ret.frameCount == 1)
-                curRes = ret.resource;
-            else
-                curRes = ret.resource.getNth(i);
-
-            ret.data[i] = readImageBytes(curRes);
+    const auto f = atlasRegions.find(image.res.getPath());
+    if (f == atlasRegions.end())
+        return false;
+
+    const AtlasRegion& rect = f->second;
+    AtlasPage& page = atlasPages[rect.page];
+
+    if (page.filter != filter)
+    {
+        LOG_DEBUG("Texture %s is requested with a different filter than its atlas page, not using the atlas", image.res.getPath());
+        return false;
+    }
+
+    if (rect.width != image.width || rect.height != image.height)
+    {
+        LOG_ERROR("Texture %s does not match its atlas region, is res/atlas.json out of date? Run the atlas target", image.res.getPath());
+        return false;
+    }
+
+    if (image.nrComponents != 4)
+    {
+        LOG_ERROR("Texture %s wasn't decoded to RGBA, not using the atlas", image.res.getPath());
+        return false;
+    }
+
+    if (page.texId == 0)
+    {
+        // allocate the whole page, the sprites are filled in as they're loaded
+        glGenTextures(1, &page.texId);
+        createTexture(page.texId, nullptr, GL_RGBA, page.width, page.height, page.filter);
+    }
+
+    // repeat the edge pixels out into the gutter, so filtering right at the edge samples the sprite itself
+    const int pad = atlasPadding;
+    const int paddedWidth = rect.width + pad * 2;
+    const int paddedHeight = rect.height + pad * 2;
+    const size_t rowBytes = size_t(rect.width) * 4;
+    atlasUpload.resize(size_t(paddedWidth) * paddedHeight * 4);
+
+    for (int y = 0; y < paddedHeight; y++)
+    {
+        const unsigned char* src = image.bytes + size_t(std::clamp(y - pad, 0, rect.height - 1)) * rowBytes;
+        unsigned char* dst = atlasUpload.data() + size_t(y) * paddedWidth * 4;
+
+        for (int x = 0; x < pad; x++)
+        {
+            std::memcpy(dst + x * 4, src, 4);
+            std::memcpy(dst + (pad + rect.width + x) * 4, src + rowBytes - 4, 4);
         }
 
-        return ret;
-#ifdef PLATFORM_EMSCRIPTEN
-    }());
-#else
-    }));
-#endif
+        std::memcpy(dst + pad * 4, src, rowBytes);
+    }
+
+    GLState::bindTexture(GL_TEXTURE_2D, page.texId);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, rect.x - pad, rect.y - pad, paddedWidth, paddedHeight,
+                    GL_RGBA, GL_UNSIGNED_BYTE, atlasUpload.data());
+
+    region.texId = page.texId;
+    region.uv = glm::vec4(float(rect.x) / page.width, float(rect.y) / page.height,
+                          float(rect.x + rect.width) / page.width, float(rect.y + rect.height) / page.height);
+
+    return true;
 }
 
-void TextureManager::loadWantedTextures()
+void TextureManager::loadAtlasManifest()
 {
-#ifdef PLATFORM_EMSCRIPTEN
-    for(auto& wantedTex : wantedTextures)
+    const Resource manifestRes("", "atlas", "json");
+    File file = File(manifestRes);
+
+    if (!file.exists())
     {
-#else
-    for(auto& wantedTexFuture : wantedTextures)
+        LOG_INFO("No texture atlas manifest found, every texture will be loaded on its own");
+        return;
+    }
+
+    const std::vector<unsigned char> data = file.readAllBytes();
+    const nlohmann::json manifest = nlohmann::json::parse(data.begin(), data.end(), nullptr, false);
+
+    if (manifest.is_discarded() || manifest.value("version", 0) != 1)
     {
-        //wantedTexFuture.wait();
-        const WantedTexture& wantedTex = wantedTexFuture.get();
-#endif
+        LOG_ERROR("Texture atlas manifest is invalid, ignoring it");
+        return;
+    }
 
-        std::vector<GLuint> texIDs;
+    atlasPadding = manifest.value("padding", 0);
 
-        for(int i = 0; i < wantedTex.frameCount; i++) {
-            GLuint texID;
-            glGenTextures(1, &texID);
+    GLint maxTextureSize = 0;
+    glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maxTextureSize);
 
-            if (wantedTex.data[i].bytes) {
-                GLint format;
-                switch (wantedTex.data[i].nrComponents) {
-                    case 1:
-                        format = GL_RED;
-                        break;
-                    case 3:
-                        format = GL_RGB;
-                        break;
-                    case 4:
-                        format = GL_RGBA;
-                        break;
-                }
+    // pages that don't fit on this GPU are left out, their sprites get standalone textures
+    std::vector<int> pageIndices;
+    for (const auto& pageJson : manifest["pages"])
+    {
+        AtlasPage page;
+        page.width = pageJson["width"];
+        page.height = pageJson["height"];
+        page.filter = (pageJson["filter"] == "nearest") ? GL_NEAREST : GL_LINEAR;
 
-                // upload to GPU
-                createTexture(texID, wantedTex.data[i].bytes, format, wantedTex.data[i].width, wantedTex.data[i].height, wantedTex.filter);
+        if (page.width > maxTextureSize || page.height > maxTextureSize)
+        {
+            LOG_ERROR("Atlas page %s is too big for this GPU (max %i), not using it", pageJson["group"].get<std::string>(), maxTextureSize);
+            pageIndices.push_back(-1);
+            continue;
+        }
+
+        pageIndices.push_back(int(atlasPages.size()));
+        atlasPages.push_back(page);
+    }
+
+    for (const auto& [path, regionJson] : manifest["regions"].items())
+    {
+        const int page = pageIndices.at(regionJson["page"].get<int>());
+        if (page == -1)
+            continue;
+
+        atlasRegions[path] = { page, regionJson["x"], regionJson["y"], regionJson["width"], regionJson["height"] };
+    }
+
+    LOG_INFO("Loaded texture atlas manifest with %i pages and %i sprites", int(atlasPages.size()), int(atlasRegions.size()));
+}
+
+int TextureManager::componentsFor(const Resource& res) const
+{
+    return atlasRegions.count(res.getPath()) != 0 ? 4 : 0;
+}
+
+GLint TextureManager::formatFor(int nrComponents)
+{
+    switch (nrComponents)
+    {
+        case 1:
+            return GL_RED;
+        case 3:
+            return GL_RGB;
+        default:
+            return GL_RGBA;
+    }
+}
+
+void TextureManager::requestTexture(const WantedTexture& tex)
+{
+    WantedTexture wanted = tex;
+    wanted.data = new Image[wanted.frameCount];
+
+    for (int i = 0; i < wanted.frameCount; i++) {
+        if (wanted.frameCount == 1)
+            wanted.data[i].res = wanted.resource;
+        else
+            wanted.data[i].res = wanted.resource.getNth(i);
+    }
+
+    // each frame decodes on its own, so long animations spread over all the workers
+    Image* images = wanted.data;
+    const JobSystem::Handle decode = Outrospection::get().jobSystem.parallelFor(size_t(wanted.frameCount), 1,
+        [this, images](size_t begin, size_t end) {
+            // the atlas regions are only written while loading the manifest, so reading them here is safe
+            for (size_t i = begin; i < end; i++)
+                images[i] = readImageBytes(images[i].res, componentsFor(images[i].res));
+        });
+
+    wantedTextures.push_back({ wanted, decode });
+}
 
-                texIDs.push_back(texID);
+void TextureManager::loadWantedTextures()
+{
+    JobSystem& jobSystem = Outrospection::get().jobSystem;
+
+    for(auto& [wantedTex, decode] : wantedTextures)
+    {
+        jobSystem.wait(decode);
+
+        std::vector<TextureRegion> frames;
+
+        for(int i = 0; i < wantedTex.frameCount; i++) {
+            if (wantedTex.data[i].bytes) {
+                // upload to GPU
+                frames.push_back(uploadImage(wantedTex.data[i], wantedTex.filter));
             } else {
                 LOG_ERROR("Texture failed to load at path: %s", wantedTex.resource.getPath());
                 LOG_ERROR("stbi_failure_reason: %s", stbi_failure_reason());
 
-                texIDs.push_back(TextureManager::MissingTexture.texId);
+                frames.push_back({ TextureManager::MissingTexture.texId });
             }
 
             stbi_image_free(wantedTex.data[i].bytes);
         }
 
-        if(texIDs.size() == 1)
+        delete[] wantedTex.data;
+
+        if(frames.size() == 1)
         {
-            textures.insert(std::make_pair(wantedTex.resource, std::make_unique<SimpleTexture>(texIDs[0])));
+            textures.insert(std::make_pair(wantedTex.resource, std::make_unique<SimpleTexture>(frames[0])));
         } else {
-            textures.insert(std::make_pair(wantedTex.resource, std::make_unique<TickableTexture>(texIDs, wantedTex.tickLength, wantedTex.loop)));
+            textures.insert(std::make_pair(wantedTex.resource, std::make_unique<TickableTexture>(frames, wantedTex.tickLength, wantedTex.loop)));
         }
     }
 
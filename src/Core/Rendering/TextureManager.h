@@ -2,7 +2,6 @@
 #include "Core.h"
 
 #include <unordered_map>
-#include <future>
 
 #ifdef USE_GLFM
 #include "glfm.h"
@@ -10,6 +9,7 @@
 #include <glad/glad.h>
 #endif
 
+#include "Core/JobSystem.h"
 #include "Core/Resource.h"
 #include "Types.h"
 
@@ -20,6 +20,27 @@ class TextureManager
 private:
     std::unordered_map<Resource, std::unique_ptr<SimpleTexture>, Hashes> textures;
 
+    // pages and sprite rects packed ahead of time by tools/AtlasPacker, see res/atlas.json
+    struct AtlasPage
+    {
+        GLuint texId = 0; // created when the first sprite on it is loaded
+        GLint filter = GL_LINEAR;
+        int width = 0, height = 0;
+    };
+    struct AtlasRegion
+    {
+        int page = 0;
+        int x = 0, y = 0;
+        int width = 0, height = 0;
+    };
+
+    std::vector<AtlasPage> atlasPages;
+    std::unordered_map<std::string, AtlasRegion> atlasRegions;
+    int atlasPadding = 0; // gutter around every region, filled with its edge pixels
+
+    // a sprite with its edges extruded into the gutter, reused for every upload
+    std::vector<unsigned char> atlasUpload;
+
 public:
 
     struct Image
@@ -60,21 +81,35 @@ public:
     static SimpleTexture MissingTexture;
     static SimpleTexture None;
 
-    static Image readImageBytes(const Resource& res);
+    // components is the channel count to convert to, 0 keeps what the file has
+    static Image readImageBytes(const Resource& res, int components = 0);
     static void free(unsigned char* data);
 
     void loadWantedTextures();
 
     DISALLOW_COPY_AND_ASSIGN(TextureManager);
 private:
-    static GLuint textureFromFile(const Resource& res, const GLint& filter);
+    void loadAtlasManifest();
+
+    TextureRegion textureFromFile(const Resource& res, const GLint& filter);
+
+    // atlas pages are RGBA, so sprites going into one are decoded to RGBA. GLES can't upload anything else into them
+    int componentsFor(const Resource& res) const;
+
+    // puts the image in its atlas page if it has one, otherwise in a texture of its own
+    TextureRegion uploadImage(const Image& image, const GLint& filter);
+    bool uploadToAtlas(const Image& image, const GLint& filter, TextureRegion& region);
+
+    static GLint formatFor(int nrComponents);
 
     static void createTexture(const GLuint& texId, const unsigned char* data, const GLint& format,
                               const GLsizei& width, const GLsizei& height, const GLint& filter);
 
-#ifdef PLATFORM_EMSCRIPTEN
-    std::vector<WantedTexture> wantedTextures;
-#else
-    std::vector<std::future<WantedTexture>> wantedTextures;
-#endif
+    // frames are decoded on the job system, loadWantedTextures() uploads them once they're done
+    struct PendingTexture
+    {
+        WantedTexture texture;
+        JobSystem::Handle decode;
+    };
+    std::vector<PendingTexture> wantedTextures;
 };
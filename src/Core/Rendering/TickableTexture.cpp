@@ -1,13 +1,13 @@
 #include "TickableTexture.h"
 
-TickableTexture::TickableTexture(const std::vector<GLuint>& texIds,
+#include "Outrospection.h"
+
+TickableTexture::TickableTexture(const std::vector<TextureRegion>& _frames,
                                  const unsigned int _frameLength, bool _shouldRestart)
-    : SimpleTexture(texIds.at(0)), textures(texIds), frameLength(_frameLength)
+    : SimpleTexture(_frames.at(0)), frames(_frames), frameLength(_frameLength)
 {
     loop = _shouldRestart;
     shouldTick = true;
-
-    texId = textures[0];
 }
 
 void TickableTexture::tick()
@@ -15,9 +15,10 @@ void TickableTexture::tick()
     if (!shouldTick)
         return;
 
-    frameTally++;
+    // frame lengths were tuned at BASE_TICK_RATE, so count in those ticks
+    frameTally += Outrospection::get().perTick(1.0f);
 
-    if (frameTally > frameLength)
+    if (frameTally > float(frameLength))
     {
         frameTally = 0;
         nextFrame();
@@ -34,16 +35,23 @@ void TickableTexture::tick(unsigned int& stepCount)
 
 void TickableTexture::nextFrame()
 {
-    if (curFrame < (textures.size() - 1))
+    if (curFrame < (frames.size() - 1))
         curFrame++;
     else if(loop)
         curFrame = 0;
 
-    texId = textures.at(curFrame);
+    texId = frames.at(curFrame).texId;
+    uv = frames.at(curFrame).uv;
+}
+
+bool TickableTexture::finished() const
+{
+    return !loop && curFrame == frames.size() - 1;
 }
 
 void TickableTexture::reset()
 {
     curFrame = 0;
-    texId = textures.at(curFrame);
+    texId = frames.at(curFrame).texId;
+    uv = frames.at(curFrame).uv;
 }
@@ -9,17 +9,18 @@ class TickableTexture : public SimpleTexture
 {
 public:
     TickableTexture() = default;
-    TickableTexture(const std::vector<GLuint>& texIds, const unsigned int _frameLength, bool _shouldRestart);
+    TickableTexture(const std::vector<TextureRegion>& frames, const unsigned int _frameLength, bool _shouldRestart);
 
     void tick() override;
     void tick(unsigned int& stepCount);
     void nextFrame();
 
     void reset() override;
+    bool finished() const override;
 private:
-    std::vector<GLuint> textures;
-    unsigned int frameLength = 5;
+    std::vector<TextureRegion> frames;
+    unsigned int frameLength = 5; // in ticks at BASE_TICK_RATE
 
-    unsigned int frameTally = 0;
+    float frameTally = 0;
     GLuint curFrame = 0;
 };
@@ -0,0 +1,182 @@
+#include "Scheduler.h"
+
+#include <algorithm>
+
+Scheduler::Scheduler() : m_currentTime(0)
+{
+    m_lists.fill(NONE);
+}
+
+Scheduler::Handle Scheduler::scheduleAt(time_t time, Callback callback)
+{
+    uint32_t index;
+    if (!m_freeTasks.empty())
+    {
+        index = m_freeTasks.back();
+        m_freeTasks.pop_back();
+    }
+    else
+    {
+        index = uint32_t(m_tasks.size());
+        m_tasks.emplace_back();
+    }
+
+    Task& task = m_tasks[index];
+    task.callback = std::move(callback);
+
+    // never due within the millisecond being processed, so a task that reschedules itself can't loop forever
+    task.time = std::max(time, m_currentTime + 1);
+
+    file(index);
+    m_pending++;
+
+    return { index, task.generation };
+}
+
+bool Scheduler::cancel(Handle handle)
+{
+    if (!isPending(handle))
+        return false;
+
+    unlink(handle.index);
+    release(handle.index);
+
+    return true;
+}
+
+bool Scheduler::isPending(Handle handle) const
+{
+    return handle.index < m_tasks.size() &&
+           m_tasks[handle.index].generation == handle.generation &&
+           m_tasks[handle.index].list != NONE;
+}
+
+void Scheduler::advance(time_t now)
+{
+    while (m_currentTime < now)
+    {
+        if (m_pending == 0)
+        {
+            m_currentTime = now;
+            break;
+        }
+
+        const time_t tick = ++m_currentTime;
+
+        // coarser levels come due when all the levels below them wrap around
+        for (int level = LEVELS - 1; level > 0; level--)
+        {
+            if ((tick & ((time_t(1) << (SLOT_BITS * level)) - 1)) == 0)
+                cascade(level);
+        }
+
+        // everything in this millisecond's slot is due
+        const int slot = int(tick & SLOT_MASK);
+        while (m_lists[slot] != NONE)
+        {
+            const uint32_t index = uint32_t(m_lists[slot]);
+            unlink(index);
+            link(index, DUE_LIST);
+        }
+
+        while (m_lists[DUE_LIST] != NONE)
+        {
+            const uint32_t index = uint32_t(m_lists[DUE_LIST]);
+            unlink(index);
+
+            // the callback may schedule more tasks and grow m_tasks, so take it out first
+            Callback callback = std::move(m_tasks[index].callback);
+            release(index);
+
+            callback();
+        }
+    }
+}
+
+size_t Scheduler::pendingCount() const
+{
+    return m_pending;
+}
+
+void Scheduler::file(uint32_t index)
+{
+    const time_t time = m_tasks[index].time;
+    if (time <= m_currentTime)
+    {
+        link(index, DUE_LIST);
+        return;
+    }
+
+    const time_t delay = std::min(time - m_currentTime, MAX_DELAY);
+    const time_t fileTime = m_currentTime + delay;
+
+    int level = 0;
+    while (level < LEVELS - 1 && delay >= (time_t(1) << (SLOT_BITS * (level + 1))))
+        level++;
+
+    const int slot = int((fileTime >> (SLOT_BITS * level)) & SLOT_MASK);
+    link(index, level * SLOTS + slot);
+}
+
+void Scheduler::link(uint32_t index, int list)
+{
+    Task& task = m_tasks[index];
+
+    task.list = list;
+    task.prev = NONE;
+    task.next = m_lists[list];
+
+    if (task.next != NONE)
+        m_tasks[task.next].prev = int32_t(index);
+
+    m_lists[list] = int32_t(index);
+}
+
+void Scheduler::unlink(uint32_t index)
+{
+    Task& task = m_tasks[index];
+
+    if (task.prev != NONE)
+        m_tasks[task.prev].next = task.next;
+    else
+        m_lists[task.list] = task.next;
+
+    if (task.next != NONE)
+        m_tasks[task.next].prev = task.prev;
+
+    task.prev = NONE;
+    task.next = NONE;
+}
+
+void Scheduler::release(uint32_t index)
+{
+    Task& task = m_tasks[index];
+
+    task.callback.reset();
+    task.list = NONE;
+    task.generation++; // outstanding handles no longer match
+
+    m_freeTasks.push_back(index);
+    m_pending--;
+}
+
+void Scheduler::cascade(int level)
+{
+    const int slot = int((m_currentTime >> (SLOT_BITS * level)) & SLOT_MASK);
+    const int list = level * SLOTS + slot;
+
+    // take the whole list first, filing can't put anything back into it
+    int32_t index = m_lists[list];
+    m_lists[list] = NONE;
+
+    while (index != NONE)
+    {
+        const int32_t next = m_tasks[index].next;
+        m_tasks[index].prev = NONE;
+        m_tasks[index].next = NONE;
+
+        file(uint32_t(index));
+
+        index = next;
+    }
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <ctime>
+#include <vector>
+
+#include "Core.h"
+#include "SmallFunction.h"
+
+// Runs callbacks at a later time, see Util::doLater.
+// Tasks live in a hierarchical timing wheel: four levels of 64 slots with 1 ms resolution, each level
+// 64 times coarser than the one below. Scheduling and cancelling are O(1), and advancing only touches
+// the slots that come due, so thousands of pending tasks cost nothing until they fire.
+class Scheduler
+{
+public:
+    using Callback = SmallFunction<void(), 48>;
+
+    // identifies a scheduled task. Stays safe to use after the task has run or been cancelled
+    struct Handle
+    {
+        uint32_t index = UINT32_MAX;
+        uint32_t generation = 0;
+    };
+
+    Scheduler();
+
+    // run callback once time (in ms of GameClock tick time) has passed.
+    // Times that already passed run on the next advance()
+    Handle scheduleAt(time_t time, Callback callback);
+
+    // returns false if the task already ran or was cancelled
+    bool cancel(Handle handle);
+    bool isPending(Handle handle) const;
+
+    // run every task that is due by now
+    void advance(time_t now);
+
+    size_t pendingCount() const;
+
+    DISALLOW_COPY_AND_ASSIGN(Scheduler);
+private:
+    static constexpr int LEVELS = 4;
+    static constexpr int SLOT_BITS = 6;
+    static constexpr int SLOTS = 1 << SLOT_BITS;
+    static constexpr uint32_t SLOT_MASK = SLOTS - 1;
+
+    // further out than this, tasks wait in the last level and get re-filed when it comes around
+    static constexpr time_t MAX_DELAY = (time_t(1) << (SLOT_BITS * LEVELS)) - 1;
+
+    static constexpr int32_t NONE = -1;
+    static constexpr int DUE_LIST = LEVELS * SLOTS; // tasks that are ready to run
+
+    struct Task
+    {
+        Callback callback;
+        time_t time = 0;
+
+        uint32_t generation = 0;
+
+        // intrusive links inside the slot's list, so tasks can be unlinked in O(1)
+        int32_t prev = NONE;
+        int32_t next = NONE;
+        int32_t list = NONE; // NONE when the task is free
+    };
+
+    void file(uint32_t index);
+    void link(uint32_t index, int list);
+    void unlink(uint32_t index);
+    void release(uint32_t index);
+
+    // re-file every task in a slot of a higher level into the levels below
+    void cascade(int level);
+
+    std::vector<Task> m_tasks;
+    std::vector<uint32_t> m_freeTasks;
+
+    std::array<int32_t, LEVELS * SLOTS + 1> m_lists;
+
+    // the last millisecond that has been processed
+    time_t m_currentTime;
+
+    size_t m_pending = 0;
+};
@@ -0,0 +1,139 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+// A move-only std::function replacement that keeps small callables (a lambda capturing a few
+// pointers) inside the object itself instead of allocating. Bigger callables still work, they
+// just end up on the heap like with std::function.
+template<typename Signature, std::size_t Capacity = 32>
+class SmallFunction;
+
+template<typename R, typename... Args, std::size_t Capacity>
+class SmallFunction<R(Args...), Capacity>
+{
+public:
+    SmallFunction() = default;
+    SmallFunction(std::nullptr_t) {}
+
+    template<typename F, typename = std::enable_if_t<!std::is_same_v<std::decay_t<F>, SmallFunction> &&
+                                                     std::is_invocable_r_v<R, std::decay_t<F>&, Args...>>>
+    SmallFunction(F&& func)
+    {
+        using Callable = std::decay_t<F>;
+
+        if constexpr (fitsInline<Callable>())
+        {
+            new (m_storage) Callable(std::forward<F>(func));
+            m_ops = &inlineOps<Callable>;
+        }
+        else
+        {
+            new (m_storage) Callable*(new Callable(std::forward<F>(func)));
+            m_ops = &heapOps<Callable>;
+        }
+    }
+
+    SmallFunction(SmallFunction&& other) noexcept
+    {
+        moveFrom(other);
+    }
+
+    SmallFunction& operator=(SmallFunction&& other) noexcept
+    {
+        if (this != &other)
+        {
+            reset();
+            moveFrom(other);
+        }
+
+        return *this;
+    }
+
+    ~SmallFunction()
+    {
+        reset();
+    }
+
+    R operator()(Args... args)
+    {
+        return m_ops->invoke(m_storage, std::forward<Args>(args)...);
+    }
+
+    explicit operator bool() const
+    {
+        return m_ops != nullptr;
+    }
+
+    void reset()
+    {
+        if (m_ops)
+        {
+            m_ops->destroy(m_storage);
+            m_ops = nullptr;
+        }
+    }
+
+    SmallFunction(const SmallFunction&) = delete;
+    SmallFunction& operator=(const SmallFunction&) = delete;
+private:
+    struct Ops
+    {
+        R (*invoke)(void* storage, Args&&... args);
+        void (*move)(void* dst, void* src); // move-constructs into dst and destroys src
+        void (*destroy)(void* storage);
+    };
+
+    template<typename F>
+    static constexpr bool fitsInline()
+    {
+        return sizeof(F) <= Capacity && alignof(F) <= alignof(std::max_align_t) &&
+               std::is_nothrow_move_constructible_v<F>;
+    }
+
+    template<typename F>
+    static constexpr Ops inlineOps = {
+        [](void* storage, Args&&... args) -> R {
+            return (*std::launder(reinterpret_cast<F*>(storage)))(std::forward<Args>(args)...);
+        },
+        [](void* dst, void* src) {
+            F* from = std::launder(reinterpret_cast<F*>(src));
+            new (dst) F(std::move(*from));
+            from->~F();
+        },
+        [](void* storage) {
+            std::launder(reinterpret_cast<F*>(storage))->~F();
+        }
+    };
+
+    // the storage only holds a pointer, so moving just hands the pointer over
+    template<typename F>
+    static constexpr Ops heapOps = {
+        [](void* storage, Args&&... args) -> R {
+            return (**std::launder(reinterpret_cast<F**>(storage)))(std::forward<Args>(args)...);
+        },
+        [](void* dst, void* src) {
+            new (dst) F*(*std::launder(reinterpret_cast<F**>(src)));
+        },
+        [](void* storage) {
+            delete *std::launder(reinterpret_cast<F**>(storage));
+        }
+    };
+
+    void moveFrom(SmallFunction& other)
+    {
+        if (other.m_ops)
+        {
+            other.m_ops->move(m_storage, other.m_storage);
+            m_ops = other.m_ops;
+            other.m_ops = nullptr;
+        }
+    }
+
+    static_assert(Capacity >= sizeof(void*), "SmallFunction needs room for at least a pointer");
+
+    alignas(std::max_align_t) unsigned char m_storage[Capacity];
+    const Ops* m_ops = nullptr;
+};
@@ -0,0 +1,169 @@
+#include "SpatialGrid.h"
+
+#include <cmath>
+
+SpatialGrid::SpatialGrid(float cellSize) : m_cellSize(cellSize), m_invCellSize(1.0f / cellSize)
+{
+}
+
+void SpatialGrid::insert(uint32_t id, glm::vec2 pos)
+{
+    if (id >= m_items.size())
+        m_items.resize(id + 1);
+
+    Item& item = m_items[id];
+    if (item.present)
+    {
+        move(id, pos);
+        return;
+    }
+
+    item.pos = pos;
+    item.present = true;
+    m_count++;
+
+    addToCell(id, keyOf(cellCoords(pos)));
+}
+
+void SpatialGrid::move(uint32_t id, glm::vec2 pos)
+{
+    if (!contains(id))
+    {
+        insert(id, pos);
+        return;
+    }
+
+    Item& item = m_items[id];
+    item.pos = pos;
+
+    const CellKey cell = keyOf(cellCoords(pos));
+    if (cell == item.cell)
+        return; // the common case, still in the same cell
+
+    removeFromCell(id);
+    addToCell(id, cell);
+}
+
+void SpatialGrid::remove(uint32_t id)
+{
+    if (!contains(id))
+        return;
+
+    removeFromCell(id);
+
+    m_items[id].present = false;
+    m_count--;
+}
+
+bool SpatialGrid::contains(uint32_t id) const
+{
+    return id < m_items.size() && m_items[id].present;
+}
+
+size_t SpatialGrid::size() const
+{
+    return m_count;
+}
+
+void SpatialGrid::queryRadius(glm::vec2 center, float radius, std::vector<uint32_t>& out) const
+{
+    const float radiusSq = radius * radius;
+
+    forEachInCells(cellCoords(center - radius), cellCoords(center + radius), [&](uint32_t id) {
+        const glm::vec2 offset = m_items[id].pos - center;
+        if (glm::dot(offset, offset) <= radiusSq)
+            out.push_back(id);
+    });
+}
+
+void SpatialGrid::queryRect(glm::vec2 min, glm::vec2 max, std::vector<uint32_t>& out) const
+{
+    forEachInCells(cellCoords(min), cellCoords(max), [&](uint32_t id) {
+        const glm::vec2 pos = m_items[id].pos;
+        if (pos.x >= min.x && pos.y >= min.y && pos.x <= max.x && pos.y <= max.y)
+            out.push_back(id);
+    });
+}
+
+uint32_t SpatialGrid::nearest(glm::vec2 pos, float maxDistance) const
+{
+    if (m_count == 0)
+        return NONE;
+
+    const glm::ivec2 center = cellCoords(pos);
+    const int maxRing = int(std::ceil(maxDistance * m_invCellSize)) + 1;
+
+    uint32_t best = NONE;
+    float bestSq = maxDistance * maxDistance;
+
+    const auto consider = [&](uint32_t id) {
+        const glm::vec2 offset = m_items[id].pos - pos;
+        const float distSq = glm::dot(offset, offset);
+        if (distSq <= bestSq)
+        {
+            best = id;
+            bestSq = distSq;
+        }
+    };
+
+    // search rings of cells around pos, from the inside out
+    for (int ring = 0; ring <= maxRing; ring++)
+    {
+        // nothing in this ring or further out can be closer than what we already have
+        const float ringDistance = float(ring - 1) * m_cellSize;
+        if (ring > 0 && ringDistance * ringDistance > bestSq)
+            break;
+
+        if (ring == 0)
+        {
+            forEachInCells(center, center, consider);
+            continue;
+        }
+
+        // top and bottom rows, then the left and right columns between them
+        forEachInCells({ center.x - ring, center.y - ring }, { center.x + ring, center.y - ring }, consider);
+        forEachInCells({ center.x - ring, center.y + ring }, { center.x + ring, center.y + ring }, consider);
+        forEachInCells({ center.x - ring, center.y - ring + 1 }, { center.x - ring, center.y + ring - 1 }, consider);
+        forEachInCells({ center.x + ring, center.y - ring + 1 }, { center.x + ring, center.y + ring - 1 }, consider);
+    }
+
+    return best;
+}
+
+glm::ivec2 SpatialGrid::cellCoords(glm::vec2 pos) const
+{
+    return { int(std::floor(pos.x * m_invCellSize)), int(std::floor(pos.y * m_invCellSize)) };
+}
+
+SpatialGrid::CellKey SpatialGrid::keyOf(glm::ivec2 cell)
+{
+    return (CellKey(cell.x) << 32) | CellKey(uint32_t(cell.y));
+}
+
+void SpatialGrid::addToCell(uint32_t id, CellKey cell)
+{
+    std::vector<uint32_t>& ids = m_cells[cell];
+
+    Item& item = m_items[id];
+    item.cell = cell;
+    item.slot = uint32_t(ids.size());
+
+    ids.push_back(id);
+}
+
+void SpatialGrid::removeFromCell(uint32_t id)
+{
+    const Item& item = m_items[id];
+
+    const auto cell = m_cells.find(item.cell);
+    std::vector<uint32_t>& ids = cell->second;
+
+    // swap with the last one so removing stays O(1)
+    const uint32_t last = ids.back();
+    ids[item.slot] = last;
+    m_items[last].slot = item.slot;
+    ids.pop_back();
+
+    if (ids.empty())
+        m_cells.erase(cell);
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include <glm.hpp>
+
+#include "Core.h"
+
+// A uniform grid of square cells, hashed so it covers any area without knowing its bounds up front.
+// Items are small integer ids (e.g. CrowdStore indices) with a position. Moving an item only touches
+// the grid when it crosses into another cell, so updating every moving item each tick stays cheap,
+// and queries only look at the cells they overlap instead of at every item.
+class SpatialGrid
+{
+public:
+    static constexpr uint32_t NONE = UINT32_MAX;
+
+    explicit SpatialGrid(float cellSize);
+
+    void insert(uint32_t id, glm::vec2 pos);
+    void move(uint32_t id, glm::vec2 pos);
+    void remove(uint32_t id);
+
+    bool contains(uint32_t id) const;
+    size_t size() const;
+
+    // these append the ids they find to out, in no particular order
+    void queryRadius(glm::vec2 center, float radius, std::vector<uint32_t>& out) const;
+    void queryRect(glm::vec2 min, glm::vec2 max, std::vector<uint32_t>& out) const;
+
+    // the closest item no further than maxDistance away, or NONE
+    uint32_t nearest(glm::vec2 pos, float maxDistance) const;
+
+    DISALLOW_COPY_AND_ASSIGN(SpatialGrid);
+private:
+    typedef int64_t CellKey;
+
+    struct Item
+    {
+        glm::vec2 pos;
+        CellKey cell = 0;
+        uint32_t slot = 0; // index inside the cell's list
+        bool present = false;
+    };
+
+    glm::ivec2 cellCoords(glm::vec2 pos) const;
+    static CellKey keyOf(glm::ivec2 cell);
+
+    void addToCell(uint32_t id, CellKey cell);
+    void removeFromCell(uint32_t id);
+
+    // calls visit(id) for every item in the cells between min and max, inclusive
+    template<typename Visitor>
+    void forEachInCells(glm::ivec2 min, glm::ivec2 max, Visitor&& visit) const
+    {
+        for (int y = min.y; y <= max.y; y++)
+        {
+            for (int x = min.x; x <= max.x; x++)
+            {
+                const auto cell = m_cells.find(keyOf({ x, y }));
+                if (cell == m_cells.end())
+                    continue;
+
+                for (const uint32_t id : cell->second)
+                    visit(id);
+            }
+        }
+    }
+
+    float m_cellSize;
+    float m_invCellSize;
+
+    std::vector<Item> m_items; // indexed by id
+    std::unordered_map<CellKey, std::vector<uint32_t>> m_cells;
+    size_t m_count = 0;
+};
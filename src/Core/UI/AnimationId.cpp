@@ -0,0 +1,42 @@
+#include "AnimationId.h"
+
+#include <unordered_map>
+#include <vector>
+
+namespace
+{
+    struct InternTable
+    {
+        std::unordered_map<std::string, AnimationId> ids;
+        std::vector<std::string> names;
+
+        InternTable()
+        {
+            ids.emplace("default", Animations::DEFAULT);
+            names.emplace_back("default");
+        }
+    };
+
+    // built on first use, components with animations can be static too
+    InternTable& table()
+    {
+        static InternTable instance;
+        return instance;
+    }
+}
+
+AnimationId Animations::intern(const std::string& name)
+{
+    InternTable& t = table();
+
+    const auto [it, inserted] = t.ids.try_emplace(name, AnimationId(t.names.size()));
+    if (inserted)
+        t.names.push_back(name);
+
+    return it->second;
+}
+
+const std::string& Animations::name(AnimationId id)
+{
+    return table().names[id];
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+typedef uint16_t AnimationId;
+
+// Animation names are interned to small integers once, so components can switch and compare
+// animations without hashing or comparing strings every time.
+namespace Animations
+{
+    // every component has a default animation, and it always has this id
+    constexpr AnimationId DEFAULT = 0;
+
+    // the same name always gives the same id
+    AnimationId intern(const std::string& name);
+
+    const std::string& name(AnimationId id);
+}
@@ -0,0 +1,197 @@
+#include "CrowdStore.h"
+
+#include <cassert>
+
+#include "Outrospection.h"
+#include "Util.h"
+#include "Core/Rendering/CrowdRenderer.h"
+
+namespace
+{
+    // in 1080p pixels
+    const glm::vec2 HUMAN_SIZE = glm::vec2(192, 270);
+    const glm::vec2 EXPLOSION_SIZE = glm::vec2(200, 200);
+
+    const glm::vec2 DEFAULT_RES = glm::vec2(1920, 1080);
+}
+
+CrowdStore::Human::Human(CrowdStore& store, uint32_t slot) : m_store(store), m_index(slot)
+{
+}
+
+uint32_t CrowdStore::Human::id() const
+{
+    return m_store.idAt(m_index);
+}
+
+glm::vec2 CrowdStore::Human::getPos() const
+{
+    return m_store.getPos(m_index);
+}
+
+glm::vec2 CrowdStore::Human::getGoal() const
+{
+    return m_store.getGoal(m_index);
+}
+
+void CrowdStore::Human::setGoal(glm::vec2 goal)
+{
+    m_store.setGoal(m_index, goal);
+}
+
+bool CrowdStore::Human::hasGoal() const
+{
+    return m_store.hasGoal(m_index);
+}
+
+void CrowdStore::Human::warpToGoal()
+{
+    m_store.warpToGoal(m_index);
+}
+
+HumanState CrowdStore::Human::getState() const
+{
+    return m_store.getState(m_index);
+}
+
+bool CrowdStore::Human::isDead() const
+{
+    return m_store.isDead(m_index);
+}
+
+bool CrowdStore::Human::isBad() const
+{
+    return m_store.isBad(m_index);
+}
+
+void CrowdStore::Human::markForDeletion()
+{
+    m_store.doom(m_index, Outrospection::get().clock.tickNowMillis());
+}
+
+void CrowdStore::Human::explode(bool silent)
+{
+    Outrospection& o = Outrospection::get();
+
+    m_store.startExploding(m_index, o.clock.tickNowMillis());
+
+    // every explosion shares one animation, so the latest one restarts it
+    SimpleTexture& explosion = o.textureManager.get(m_store.m_explosion);
+    explosion.reset();
+    explosion.shouldTick = true;
+
+    if (!silent)
+        o.audioManager.play("explode", 0.5);
+}
+
+CrowdStore::CrowdStore() : CrowdSlots(HUMAN_SIZE), m_catalog(Outrospection::get().costumeCatalog)
+{
+    m_explosion = animatedTexture({"ObjectData/", "explosion"}, 2, 8, GL_NEAREST, false);
+
+    for (int layer = 0; layer < LAYER_COUNT; layer++)
+        m_partSlots[layer].assign(m_catalog.partCount(layer), -2);
+}
+
+uint32_t CrowdStore::spawn(glm::vec2 pos, glm::vec2 goal, const Costume& costume)
+{
+    return CrowdSlots::spawn(pos, goal, costume, m_catalog.isBad(costume));
+}
+
+CrowdStore::Human CrowdStore::get(uint32_t id)
+{
+    // a dead human's id points nowhere, check contains() first for ids kept around
+    assert(contains(id));
+    return Human(*this, slotOf(id));
+}
+
+void CrowdStore::expireDeadlines(time_t now)
+{
+    CrowdSlots::expireDeadlines(now, [this](uint32_t slot) {
+        Human(*this, slot).explode();
+    });
+}
+
+void CrowdStore::draw(CrowdRenderer& crowd) const
+{
+    Outrospection& o = Outrospection::get();
+
+    const float alpha = o.getTickAlpha();
+    const glm::vec2 sizeRatio = *o.curFbResolution / DEFAULT_RES;
+    const glm::vec2 humanSize = HUMAN_SIZE * sizeRatio;
+
+    crowd.begin();
+
+    m_leftovers.clear();
+
+    const size_t count = slotCount();
+    for (uint32_t i = 0; i < count; i++)
+    {
+        const HumanState state = m_state[i];
+        if (state == HumanState::DEAD)
+            continue;
+
+        if (state == HumanState::EXPLODING)
+        {
+            m_leftovers.push_back(i);
+            continue;
+        }
+
+        const Costume& costume = m_costume[i];
+        std::array<int, LAYER_COUNT> slots;
+
+        bool ready = true;
+        for (int layer = 0; layer < LAYER_COUNT; layer++)
+        {
+            int& slot = m_partSlots[layer][costume.parts[layer]];
+            if (slot == -2)
+                slot = crowd.slotFor(m_catalog.getPart(layer, costume.parts[layer]));
+
+            slots[layer] = slot;
+            ready &= crowd.hasSlot(slot);
+        }
+
+        if (!ready)
+        {
+            m_leftovers.push_back(i);
+            continue;
+        }
+
+        const glm::vec2 pos = drawPos(i, alpha) * sizeRatio;
+
+        // face the direction we're walking in
+        crowd.add(pos, humanSize, m_facingRight[i], 1.0f, slots);
+    }
+
+    crowd.draw(o.shaders["crowd"]);
+
+    for (const uint32_t index : m_leftovers)
+        drawSprite(index);
+}
+
+glm::vec2 CrowdStore::drawPos(uint32_t index, float alpha) const
+{
+    return { Util::lerp(m_prevX[index], m_posX[index], alpha), Util::lerp(m_prevY[index], m_posY[index], alpha) };
+}
+
+void CrowdStore::drawSprite(uint32_t index) const
+{
+    Outrospection& o = Outrospection::get();
+    SpriteBatch& batch = o.spriteBatch;
+
+    const glm::vec2 sizeRatio = *o.curFbResolution / DEFAULT_RES;
+    const float alpha = o.getTickAlpha();
+    const glm::vec2 pos = drawPos(index, alpha) * sizeRatio;
+
+    if (m_state[index] == HumanState::EXPLODING)
+    {
+        const SimpleTexture& tex = o.textureManager.get(m_explosion);
+        if (!(tex == TextureManager::None))
+            batch.submit(o.shaders["sprite"], tex.texId, pos, EXPLOSION_SIZE * sizeRatio, tex.getUV(), glm::vec4(1));
+
+        return;
+    }
+
+    // all five layers composited once, then drawn as one sprite
+    const SimpleTexture tex = o.costumeCache.get(m_costume[index]);
+    batch.submit(o.shaders["costume"], tex.texId, pos, HUMAN_SIZE * sizeRatio, tex.getUV(m_facingRight[index]), glm::vec4(1));
+}
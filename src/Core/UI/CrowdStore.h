@@ -0,0 +1,92 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <ctime>
+#include <vector>
+
+#include <glm.hpp>
+
+#include "Core.h"
+#include "Core/CostumeCatalog.h"
+#include "Core/CrowdSlots.h"
+#include "Core/Resource.h"
+
+class CrowdRenderer;
+
+// The humans of GUIPeople, kept as one array per field instead of one UIHuman each, so the loops
+// that run every tick only stream through the fields they actually use. CrowdSlots does the
+// storage, this adds what needs the engine: the clock, explosions and drawing.
+// A human's costume is five indices into the shared CostumeCatalog, so spawning one doesn't
+// allocate once the slot arrays and grid cells have grown to the size of the crowd.
+class CrowdStore : public CrowdSlots
+{
+public:
+    static constexpr int LAYER_COUNT = CostumeCatalog::LAYER_COUNT;
+
+    // a thin reference to one human, for code that deals with them one at a time.
+    // Only valid until the next tick, hold on to id() instead
+    class Human
+    {
+    public:
+        Human(CrowdStore& store, uint32_t slot);
+
+        uint32_t id() const;
+
+        glm::vec2 getPos() const;
+        glm::vec2 getGoal() const;
+
+        void setGoal(glm::vec2 goal);
+        bool hasGoal() const;
+        void warpToGoal();
+
+        HumanState getState() const;
+        bool isDead() const;
+        bool isBad() const;
+
+        void markForDeletion();
+        void explode(bool silent = false);
+
+    private:
+        CrowdStore& m_store;
+        uint32_t m_index; // slot
+    };
+
+    CrowdStore();
+
+    // returns the id of the new human
+    uint32_t spawn(glm::vec2 pos, glm::vec2 goal, const Costume& costume);
+
+    // id has to be one contains() is true for
+    Human get(uint32_t id);
+
+    // calls visit(Human) for every human that isn't dead yet, in drawing order
+    template<typename Visitor>
+    void forEach(Visitor&& visit)
+    {
+        forEachSlot([&](uint32_t slot) { visit(Human(*this, slot)); });
+    }
+
+    // explode doomed humans and kill exploding ones once their deadline passed
+    void expireDeadlines(time_t now);
+
+    // costumed humans go into one instanced crowd draw, explosions (and costumes the crowd renderer
+    // hasn't uploaded yet) go through the sprite batch
+    void draw(CrowdRenderer& crowd) const;
+
+    DISALLOW_COPY_AND_ASSIGN(CrowdStore);
+private:
+    // between the previous tick and the latest one, in 1080p pixels
+    glm::vec2 drawPos(uint32_t index, float alpha) const;
+    void drawSprite(uint32_t index) const;
+
+    const CostumeCatalog& m_catalog;
+    // the crowd renderer's texture array slice of every costume part, resolved on first draw.
+    // -2 means not resolved yet
+    mutable std::array<std::vector<int>, LAYER_COUNT> m_partSlots;
+
+    Resource m_explosion;
+
+    // humans the crowd renderer couldn't take this frame, kept around to avoid allocating every frame
+    mutable std::vector<uint32_t> m_leftovers;
+};
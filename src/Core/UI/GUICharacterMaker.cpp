@@ -11,98 +11,74 @@ GUICharacterMaker::GUICharacterMaker() : GUILayer("Character maker"), m_human(UI
     m_ufoBeam.opacityGoal = 0.0;
     m_ufoBeam.warpToGoal();
 
-    m_human.addAnimation("exploding", animatedTexture({"ObjectData/", "explosion"}, 2, 8, GL_NEAREST, false));
-    m_human.addAnimation("dead", Resource());
-
-    m_human.addToLayer(HumanLayer::HAT, Resource());
-    m_human.addToLayer(HumanLayer::HAT, "hat/0");
-    m_human.addToLayer(HumanLayer::HAT, "hat/1");
-    m_human.addToLayer(HumanLayer::HAT, "hat/2", true);
-    m_human.addToLayer(HumanLayer::HAT, "hat/3");
-    m_human.addToLayer(HumanLayer::FACE, "face/0");
-    m_human.addToLayer(HumanLayer::FACE, "face/1");
-    m_human.addToLayer(HumanLayer::FACE, "face/2");
-    m_human.addToLayer(HumanLayer::FACE, "face/3", true);
-    m_human.addToLayer(HumanLayer::FACE, "face/4");
-    m_human.addToLayer(HumanLayer::TORSO, "torso/0");
-    m_human.addToLayer(HumanLayer::TORSO, "torso/1");
-    m_human.addToLayer(HumanLayer::TORSO, "torso/2", true);
-    m_human.addToLayer(HumanLayer::TORSO, "torso/3");
-    m_human.addToLayer(HumanLayer::TORSO, "torso/4");
-    m_human.addToLayer(HumanLayer::HANDS, Resource());
-    m_human.addToLayer(HumanLayer::HANDS, "hands/0");
-    m_human.addToLayer(HumanLayer::HANDS, "hands/1", true);
-    m_human.addToLayer(HumanLayer::HANDS, "hands/2");
-    m_human.addToLayer(HumanLayer::HANDS, "hands/3");
-    m_human.addToLayer(HumanLayer::LEGS, "legs/0");
-    m_human.addToLayer(HumanLayer::LEGS, "legs/1", true);
-    m_human.addToLayer(HumanLayer::LEGS, "legs/2");
-    m_human.addToLayer(HumanLayer::LEGS, "legs/3");
-    m_human.addToLayer(HumanLayer::LEGS, "legs/4");
-
-    m_human.rollTheDice();
+    m_beamTimer.onExpired([this]() {
+        m_ufoBeam.opacityGoal = 0.0;
+    });
+
+    m_human.rollTheDice(m_random);
 
     buttons.push_back(new UIButton("hatL", simpleTexture({"ObjectData/UI/", "leftArrow"}, GL_LINEAR), UITransform(70, 70, 82, 108), Bounds(), [&](UIButton&, int) -> void {
         m_human.changeLayer(HumanLayer::HAT, -1);
-        Outrospection::get().audioManager.play("pageTurn" + std::to_string(int(rand() / float(RAND_MAX) * 4)));
+        Outrospection::get().audioManager.play("pageTurn" + std::to_string(m_sfxRandom.below(4)));
     }));
     buttons.push_back(new UIButton("hatR", simpleTexture({"ObjectData/UI/", "rightArrow"}, GL_LINEAR), UITransform(800, 70, 82, 108), Bounds(), [&](UIButton&, int) -> void {
         m_human.changeLayer(HumanLayer::HAT, 1);
-        Outrospection::get().audioManager.play("pageTurn" + std::to_string(int(rand() / float(RAND_MAX) * 4)));
+        Outrospection::get().audioManager.play("pageTurn" + std::to_string(m_sfxRandom.below(4)));
     }));
 
     buttons.push_back(new UIButton("faceL", simpleTexture({"ObjectData/UI/", "leftArrow"}, GL_LINEAR), UITransform(70, 250, 82, 108), Bounds(), [&](UIButton&, int) -> void {
         m_human.changeLayer(HumanLayer::FACE, -1);
-        Outrospection::get().audioManager.play("pageTurn" + std::to_string(int(rand() / float(RAND_MAX) * 4)));
+        Outrospection::get().audioManager.play("pageTurn" + std::to_string(m_sfxRandom.below(4)));
     }));
     buttons.push_back(new UIButton("faceR", simpleTexture({"ObjectData/UI/", "rightArrow"}, GL_LINEAR), UITransform(800, 250, 82, 108), Bounds(), [&](UIButton&, int) -> void {
         m_human.changeLayer(HumanLayer::FACE, 1);
-        Outrospection::get().audioManager.play("pageTurn" + std::to_string(int(rand() / float(RAND_MAX) * 4)));
+        Outrospection::get().audioManager.play("pageTurn" + std::to_string(m_sfxRandom.below(4)));
     }));
 
     buttons.push_back(new UIButton("torsoL", simpleTexture({"ObjectData/UI/", "leftArrow"}, GL_LINEAR), UITransform(70, 430, 82, 108), Bounds(), [&](UIButton&, int) -> void {
         m_human.changeLayer(HumanLayer::TORSO, -1);
-        Outrospection::get().audioManager.play("pageTurn" + std::to_string(int(rand() / float(RAND_MAX) * 4)));
+        Outrospection::get().audioManager.play("pageTurn" + std::to_string(m_sfxRandom.below(4)));
     }));
     buttons.push_back(new UIButton("torsoR", simpleTexture({"ObjectData/UI/", "rightArrow"}, GL_LINEAR), UITransform(800, 430, 82, 108), Bounds(), [&](UIButton&, int) -> void {
         m_human.changeLayer(HumanLayer::TORSO, 1);
-        Outrospection::get().audioManager.play("pageTurn" + std::to_string(int(rand() / float(RAND_MAX) * 4)));
+        Outrospection::get().audioManager.play("pageTurn" + std::to_string(m_sfxRandom.below(4)));
     }));
 
     buttons.push_back(new UIButton("handsL", simpleTexture({"ObjectData/UI/", "leftArrow"}, GL_LINEAR), UITransform(70, 610, 82, 108), Bounds(), [&](UIButton&, int) -> void {
         m_human.changeLayer(HumanLayer::HANDS, -1);
-        Outrospection::get().audioManager.play("pageTurn" + std::to_string(int(rand() / float(RAND_MAX) * 4)));
+        Outrospection::get().audioManager.play("pageTurn" + std::to_string(m_sfxRandom.below(4)));
     }));
     buttons.push_back(new UIButton("handsR", simpleTexture({"ObjectData/UI/", "rightArrow"}, GL_LINEAR), UITransform(800, 610, 82, 108), Bounds(), [&](UIButton&, int) -> void {
         m_human.changeLayer(HumanLayer::HANDS, 1);
-        Outrospection::get().audioManager.play("pageTurn" + std::to_string(int(rand() / float(RAND_MAX) * 4)));
+        Outrospection::get().audioManager.play("pageTurn" + std::to_string(m_sfxRandom.below(4)));
     }));
 
     buttons.push_back(new UIButton("legsL", simpleTexture({"ObjectData/UI/", "leftArrow"}, GL_LINEAR), UITransform(70, 790, 82, 108), Bounds(), [&](UIButton&, int) -> void {
         m_human.changeLayer(HumanLayer::LEGS, -1);
-        Outrospection::get().audioManager.play("pageTurn" + std::to_string(int(rand() / float(RAND_MAX) * 4)));
+        Outrospection::get().audioManager.play("pageTurn" + std::to_string(m_sfxRandom.below(4)));
     }));
     buttons.push_back(new UIButton("legsR", simpleTexture({"ObjectData/UI/", "rightArrow"}, GL_LINEAR), UITransform(800, 790, 82, 108), Bounds(), [&](UIButton&, int) -> void {
         m_human.changeLayer(HumanLayer::LEGS, 1);
-        Outrospection::get().audioManager.play("pageTurn" + std::to_string(int(rand() / float(RAND_MAX) * 4)));
+        Outrospection::get().audioManager.play("pageTurn" + std::to_string(m_sfxRandom.below(4)));
     }));
 
+    const AnimationId hovered = Animations::intern("hovered");
     for(UIButton* button : buttons)
     {
         if(button->text[button->text.length() - 1] == 'L')
-            button->addAnimation("hovered", simpleTexture({"ObjectData/UI/", "leftArrowHover"}, GL_LINEAR));
+            button->addAnimation(hovered, simpleTexture({"ObjectData/UI/", "leftArrowHover"}, GL_LINEAR));
         if(button->text[button->text.length() - 1] == 'R')
-            button->addAnimation("hovered", simpleTexture({"ObjectData/UI/", "rightArrowHover"}, GL_LINEAR));
+            button->addAnimation(hovered, simpleTexture({"ObjectData/UI/", "rightArrowHover"}, GL_LINEAR));
 
-        button->onHover = [](UIButton& button, int) { button.setAnimation("hovered"); };
-        button->onUnhover = [](UIButton& button, int) { button.setAnimation("default"); };
+        button->onHover = [hovered](UIButton& button, int) { button.setAnimation(hovered); };
+        button->onUnhover = [](UIButton& button, int) { button.setAnimation(Animations::DEFAULT); };
     }
 
     buttons.push_back(new UIButton("UFO", simpleTexture({"ObjectData/", "ufo"}, GL_LINEAR), UITransform(1050, 40, 260, 300), Bounds(UITransform(1100, 20, 200), BoundsShape::Circle), [&](UIButton&, int)
     {
         ((GUIPeople*)(Outrospection::get().layerPtrs["people"]))->addHuman(m_human);
         Outrospection::get().audioManager.play("reverseAbduction", 0.2);
-        Outrospection::get().audioManager.play("noo" + std::to_string(int(rand() / float(RAND_MAX) * 3)));
+        Outrospection::get().audioManager.play("noo" + std::to_string(m_sfxRandom.below(3)));
 
         m_ufoBeam.opacityGoal = 1.0;
 
@@ -110,7 +86,7 @@ GUICharacterMaker::GUICharacterMaker() : GUILayer("Character maker"), m_human(UI
         m_beamTimer.start();
 
         // reset human with new random stats (roll the dice)
-        m_human.rollTheDice();
+        m_human.rollTheDice(m_random);
     }));
 }
 
@@ -123,12 +99,6 @@ void GUICharacterMaker::tick()
     {
         button->tick();
     }
-
-    m_beamTimer.tick();
-    if(m_beamTimer.ended()) {
-        m_ufoBeam.opacityGoal = 0.0;
-    }
-
 }
 
 void GUICharacterMaker::draw() const
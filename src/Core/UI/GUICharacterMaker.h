@@ -21,6 +21,10 @@ private:
 
     UIHuman m_human;
 
+    Random& m_random = RandomStreams::stream("costumes");
+    // kept apart so which sounds play never changes the costumes that get rolled
+    Random& m_sfxRandom = RandomStreams::stream("sfx");
+
     UIComponent m_ufoBeam;
 
     Timer m_beamTimer;
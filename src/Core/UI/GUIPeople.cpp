@@ -3,10 +3,14 @@
 #include "UIHuman.h"
 #include "UIButton.h"
 #include "GUIStats.h"
+#include "Core/Rendering/CrowdRenderer.h"
+#include "Events/MouseEvent.h"
 
 GUIPeople::GUIPeople() : GUILayer("People renderer", false)
 {
-
+    m_people.onPopulationChanged([](const CrowdStore::Population& population) {
+        ((GUIStats*) Outrospection::get().layerPtrs["stats"])->setPeopleCount(population.alive);
+    });
 }
 
 GUIPeople::~GUIPeople()
@@ -22,34 +26,37 @@ void GUIPeople::tick()
         button->tick();
     }
 
-    for(int i = 0; i < m_people.size(); i++)
-    {
-        UIHuman& human = m_people[i];
+    auto& o = Outrospection::get();
+
+    m_people.beginTick();
+
+    // one roll per human, drawn in a single batch
+    m_rolls.resize(m_people.size());
+    m_random.fill(m_rolls.data(), m_rolls.size());
+
+    size_t roll = 0;
+    m_people.forEach([&](CrowdStore::Human human) {
+        const float random = m_rolls[roll++];
 
         if(!human.hasGoal() && !m_ending) {
 
             // random chance to assign a new goal
-            float random = rand() / float(RAND_MAX);
-
-            if(random >= 0.995) {
+            if(random >= 0.995f) {
 
-                float r = 300 * sqrt(rand() / float(RAND_MAX));
-                float theta = (rand() / float(RAND_MAX)) * 2 * M_PI;
+                float r = 300 * sqrt(m_random.nextFloat());
+                float theta = m_random.nextFloat() * 2 * M_PI;
 
                 glm::vec2 goal(1100 + 440 - 96, 20 + 440 - 135);
                 goal.x += r * cos(theta);
                 goal.y += r * sin(theta);
 
-                human.setGoal(goal.x, goal.y);
+                human.setGoal(goal);
             }
         }
+    });
 
-        human.tick();
-    }
-
-
-
-    ((GUIStats*) Outrospection::get().layerPtrs["stats"])->setPeopleCount(humanCount());
+    m_people.move(o.perTickLerp(0.01f));
+    m_people.expireDeadlines(o.clock.tickNowMillis());
 }
 
 void GUIPeople::draw() const
@@ -59,81 +66,81 @@ void GUIPeople::draw() const
         button->draw();
     }
 
-    for(auto& human : m_people)
-    {
-        human.draw();
-    }
+    m_people.draw(Outrospection::get().crowdRenderer);
 }
 
 
-void GUIPeople::addHuman(UIHuman human)
+void GUIPeople::addHuman(const UIHuman& human)
 {
-    human.setScale(192, 270);
-    human.setPosition(1050, 80);
-
-    human.setGoal(1550, 520);
-    m_people.emplace_back(human);
-
-    int newHumanIndex = m_people.size() - 1;
+    const uint32_t newHuman = m_people.spawn(glm::vec2(1050, 80), glm::vec2(1550, 520), human.getCostume());
 
     if(human.isBad()) {
-        Util::doLater([this]() {
-            for(int i = 0; i < m_people.size() - 1; i++) // exclude the new human that is bad
-            {
-                if(m_people[i].isDead())
-                    continue;
-
-                float random = rand() / float(RAND_MAX);
-                if(random > 0.75)
+        Util::doLater([this, newHuman]() {
+            m_people.forEach([&](CrowdStore::Human other) {
+                if(other.id() == newHuman || other.isDead()) // exclude the new human that is bad
+                    return;
+
+                if(m_random.chance(0.25f))
                 {
-                    m_people[i].markForDeletion();
+                    other.markForDeletion();
                 }
-            }
+            });
         }, 250);
 
         // delete bad human
-        m_people[newHumanIndex].markForDeletion();
+        m_people.get(newHuman).markForDeletion();
     }
 }
 
 int GUIPeople::humanCount()
 {
-    // update stats
-    int humanCount = 0;
-    for(UIHuman& h : m_people) {
-        if(!h.isDead()) {
-            humanCount++;
-        }
-    }
-
-    return humanCount;
+    return int(m_people.population().alive);
 }
 
 void GUIPeople::explodeAll()
 {
-    for(UIHuman& h : m_people) {
+    m_people.forEach([](CrowdStore::Human h) {
         if(!h.isDead()) {
             h.explode(true); // explode silently to avoid cacophony
         }
-    }
+    });
 }
 
 void GUIPeople::center()
 {
     m_ending = true;
 
-    for(UIHuman& h : m_people) {
+    m_people.forEach([this](CrowdStore::Human h) {
         if(!h.isDead()) {
-            float r = 200 * sqrt(rand() / float(RAND_MAX));
-            float theta = (rand() / float(RAND_MAX)) * 2 * M_PI;
+            float r = 200 * sqrt(m_random.nextFloat());
+            float theta = m_random.nextFloat() * 2 * M_PI;
 
             glm::vec2 goal(520 + 440 - 96, 20 + 440 - 135);
             goal.x += r * cos(theta);
             goal.y += r * sin(theta);
 
-            h.setGoal(goal.x, goal.y);
+            h.setGoal(goal);
             h.warpToGoal();
         }
-    }
+    });
 }
 
+#ifdef _DEBUG
+bool GUIPeople::onMousePressed(MouseButtonPressedEvent& event)
+{
+    if(GUILayer::onMousePressed(event))
+        return true;
+
+    // the cursor callback already took the letterbox off and scaled it to 1080p, like UIButton expects
+    const uint32_t id = m_people.humanAt(Outrospection::get().lastMousePos);
+    if(id == CrowdStore::NONE)
+        return false;
+
+    CrowdStore::Human human = m_people.get(id);
+
+    LOG_INFO("Human %u: %s%s, at (%.0f, %.0f), heading to (%.0f, %.0f)", id, humanStateName(human.getState()),
+             human.isBad() ? ", bad" : "", human.getPos().x, human.getPos().y, human.getGoal().x, human.getGoal().y);
+
+    return false;
+}
+#endif
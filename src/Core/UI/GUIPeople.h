@@ -1,6 +1,8 @@
 #pragma once
 
 #include "GUILayer.h"
+#include "CrowdStore.h"
+#include "Core/Random.h"
 #include <glm.hpp>
 
 class UIHuman;
@@ -14,15 +16,23 @@ public:
     void tick() override;
     void draw() const override;
 
-    void addHuman(UIHuman human);
+    void addHuman(const UIHuman& human);
     int humanCount();
 
     void explodeAll();
     void center();
 
+#ifdef _DEBUG
+    // click on a human to log what it's up to
+    bool onMousePressed(MouseButtonPressedEvent& event) override;
+#endif
+
     DISALLOW_COPY_AND_ASSIGN(GUIPeople);
 private:
-    std::vector<UIHuman> m_people;
+    CrowdStore m_people;
+
+    Random& m_random = RandomStreams::stream("crowd");
+    std::vector<float> m_rolls;
 
     bool m_ending = false;
 };
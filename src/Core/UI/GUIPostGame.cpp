@@ -126,135 +126,126 @@ void GUIPostGame::start(bool goodEnding)
     // start end cutscene
     m_backgroundFade.opacityGoal = 1.0;
 
+    o.playCutscene(playEnding(goodEnding));
+}
+
+Cutscene GUIPostGame::playEnding(bool goodEnding)
+{
+    auto& o = Outrospection::get();
+
     // do stuff while faded
-    Util::doLater([this, &o](){
-        m_ufo.visible = true;
-        m_boss.visible = true;
-        m_starrySky.visible = true;
-        o.popOverlay(o.layerPtrs["characterMaker"]);
-        o.popOverlay(o.layerPtrs["stats"]);
-
-        m_backgroundFade.opacityGoal = 0.0;
-    }, 2000);
-
-    Util::doLater([this](){
-        m_boss.setGoal(1, 0);
-        m_bossText.visible = true;
-    }, 3000);
-
-    Util::doLater([this](){
-        m_ufoText.visible = true;
-        m_bossText.visible = false;
-    }, 5000);
-
-    Util::doLater([this](){
-        m_ufo.setAnimation("shrug");
-    }, 6000);
-
-    Util::doLater([this, goodEnding](){
-        m_ufoText.visible = false;
-        m_bossText.visible = true;
-
-        if(goodEnding) {
-            m_bossText.setAnimation("so that's what humans");
-        } else {
-            m_bossText.setAnimation("where did the humans go?");
-        }
-    }, 7000);
-
-    Util::doLater([this, goodEnding](){
-        if(goodEnding)
-            m_ufo.setAnimation("thumbsup");
-        else
-            m_ufo.setAnimation("sad");
-    }, 8000);
-
-    Util::doLater([this, goodEnding](){
-        m_ufoText.visible = false;
-        m_bossText.visible = true;
-
-        if(goodEnding) {
-            m_bossText.setAnimation("look like. huh.");
-        } else {
-            m_bossText.setAnimation("ok boom time.");
-        }
-    }, 9000);
-
-    Util::doLater([this, goodEnding](){
-        if(!goodEnding)
-            m_ufo.setAnimation("boom");
-    }, 10000);
-
-    Util::doLater([this](){
-        m_backgroundFade.opacityGoal = 1.0;
-    }, 11000);
+    co_await Cutscene::wait(2000);
+    m_ufo.visible = true;
+    m_boss.visible = true;
+    m_starrySky.visible = true;
+    o.popOverlay(o.layerPtrs["characterMaker"]);
+    o.popOverlay(o.layerPtrs["stats"]);
 
-    // wait for cutscene to be done
-    Util::doLater([&o, this]() {
-        m_boss.visible = false;
-        m_ufo.visible = false;
-        m_starrySky.visible = false;
+    m_backgroundFade.opacityGoal = 0.0;
 
-        m_backgroundFade.animationSpeed = 0.7;
-        m_backgroundFade.opacityGoal = 0.0;
+    co_await Cutscene::wait(1000);
+    m_boss.setGoal(1, 0);
+    m_bossText.visible = true;
 
-        ((GUIBackground*)o.layerPtrs["background"])->startEndSequence();
-    }, 12000);
+    co_await Cutscene::wait(2000);
+    m_ufoText.visible = true;
+    m_bossText.visible = false;
 
+    co_await Cutscene::wait(1000);
+    m_ufo.setAnimation("shrug");
 
-    // wait for background to be done
-    Util::doLater([this]() {
+    co_await Cutscene::wait(1000);
+    m_ufoText.visible = false;
+    m_bossText.visible = true;
+
+    if(goodEnding) {
+        m_bossText.setAnimation("so that's what humans");
+    } else {
+        m_bossText.setAnimation("where did the humans go?");
+    }
 
-        m_backgroundFade.animationSpeed = 0.1;
+    co_await Cutscene::wait(1000);
+    if(goodEnding)
+        m_ufo.setAnimation("thumbsup");
+    else
+        m_ufo.setAnimation("sad");
 
-        m_backgroundFade.opacityGoal = 1.0;
-        m_planetDown.opacityGoal = 1.0;
-    }, 14150);
+    co_await Cutscene::wait(1000);
+    m_ufoText.visible = false;
+    m_bossText.visible = true;
 
-    Util::doLater([this, &o](){
-        m_planetDown.setAnimation("planetDown");
-        o.audioManager.play("planetDown");
-    }, 15150);
-    Util::doLater([this](){
-        m_planetDown.opacityGoal = 0.0;
-    }, 17150);
+    if(goodEnding) {
+        m_bossText.setAnimation("look like. huh.");
+    } else {
+        m_bossText.setAnimation("ok boom time.");
+    }
 
-    Util::doLater([this](){
-        m_backgroundFade.opacityGoal = 1.0;
-    }, 17500);
+    co_await Cutscene::wait(1000);
+    if(!goodEnding)
+        m_ufo.setAnimation("boom");
 
-    Util::doLater([this, &o](){
-        m_creditsSequence.opacityGoal = 1.0;
-        m_creditsSequence.warpToGoal();
+    co_await Cutscene::wait(1000);
+    m_backgroundFade.opacityGoal = 1.0;
 
-        m_backgroundFade.moveLinearly = true;
-        m_backgroundFade.setGoal(0, 2000);
+    // wait for cutscene to be done
+    co_await Cutscene::wait(1000);
+    m_boss.visible = false;
+    m_ufo.visible = false;
+    m_starrySky.visible = false;
+
+    m_backgroundFade.animationSpeed = 0.7;
+    m_backgroundFade.opacityGoal = 0.0;
+
+    ((GUIBackground*)o.layerPtrs["background"])->startEndSequence();
+
+    // wait for background to be done
+    co_await Cutscene::wait(2150);
+    m_backgroundFade.animationSpeed = 0.1;
+
+    m_backgroundFade.opacityGoal = 1.0;
+    m_planetDown.opacityGoal = 1.0;
+
+    co_await Cutscene::wait(1000);
+    m_planetDown.setAnimation("planetDown");
+    o.audioManager.play("planetDown");
+
+    co_await Cutscene::animationDone(m_planetDown);
+    m_planetDown.opacityGoal = 0.0;
+
+    co_await Cutscene::wait(350);
+    m_backgroundFade.opacityGoal = 1.0;
+
+    co_await Cutscene::wait(1000);
+    m_creditsSequence.opacityGoal = 1.0;
+    m_creditsSequence.warpToGoal();
 
-        buttons.push_back(new UIButton("octopuzzlerURL", Resource(), UITransform(960, 350, 900, 100), Bounds(), [](UIButton&, int){
-            Util::openLink("https://2foamboards.itch.io/octopuzzler");
-        }));
+    m_backgroundFade.moveLinearly = true;
+    m_backgroundFade.setGoal(0, 2000);
 
-        buttons.push_back(new UIButton("gitURL", Resource(), UITransform(560, 500, 1300, 100), Bounds(), [](UIButton&, int){
-            Util::openLink("https://github.com/RealTheSunCat/Reverse-Abduction-Simulator");
-        }));
+    buttons.push_back(new UIButton("octopuzzlerURL", Resource(), UITransform(960, 350, 900, 100), Bounds(), [](UIButton&, int){
+        Util::openLink("https://2foamboards.itch.io/octopuzzler");
+    }));
 
-        buttons.push_back(new UIButton("exit", simpleTexture({"ObjectData/UI/", "exitButton"}, GL_LINEAR), UITransform(50, 913, 126, 127), Bounds(), [](UIButton&, int){
-            Outrospection::get().stop();
-        }));
-        buttons[buttons.size() - 1]->addAnimation("hovered", simpleTexture({"ObjectData/UI/", "exitButtonHover"}, GL_LINEAR));
+    buttons.push_back(new UIButton("gitURL", Resource(), UITransform(560, 500, 1300, 100), Bounds(), [](UIButton&, int){
+        Util::openLink("https://github.com/RealTheSunCat/Reverse-Abduction-Simulator");
+    }));
 
-        buttons[buttons.size() - 1]->onHover = [] (UIButton& b, int) {
-            b.setAnimation("hovered");
-        };
+    buttons.push_back(new UIButton("exit", simpleTexture({"ObjectData/UI/", "exitButton"}, GL_LINEAR), UITransform(50, 913, 126, 127), Bounds(), [](UIButton&, int){
+        Outrospection::get().stop();
+    }));
+    const AnimationId hovered = Animations::intern("hovered");
+    buttons[buttons.size() - 1]->addAnimation(hovered, simpleTexture({"ObjectData/UI/", "exitButtonHover"}, GL_LINEAR));
 
-        buttons[buttons.size() - 1]->onUnhover = [] (UIButton& b, int) {
-            b.setAnimation("default");
-        };
+    buttons[buttons.size() - 1]->onHover = [hovered] (UIButton& b, int) {
+        b.setAnimation(hovered);
+    };
 
-        m_scoreValueText.visible = true;
-        m_human.visible = true;
-    }, 18500);
+    buttons[buttons.size() - 1]->onUnhover = [] (UIButton& b, int) {
+        b.setAnimation(Animations::DEFAULT);
+    };
 
+    m_scoreValueText.visible = true;
+    m_human.visible = true;
 }
 
 void GUIPostGame::setScore(int score)
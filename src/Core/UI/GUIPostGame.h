@@ -2,6 +2,7 @@
 
 #include "GUILayer.h"
 #include "UIComponent.h"
+#include "Core/Cutscene.h"
 
 class GUIPostGame : public GUILayer
 {
@@ -18,6 +19,8 @@ public:
     ~GUIPostGame();
 
 private:
+    Cutscene playEnding(bool goodEnding);
+
     UIComponent m_backgroundFade;
     UIComponent m_planetDown;
     UIComponent m_creditsSequence;
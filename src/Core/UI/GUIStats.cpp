@@ -27,8 +27,22 @@ GUIStats::GUIStats() : GUILayer("Stats", false), m_timerDisplay("00:00", Resourc
     m_peopleCount.textSize = 1.5;
     m_peopleCount.textColor = Color(0.9843, 0.9490, 0.8039);
 
+    setPeopleCount(0);
+
     m_planetCount.textSize = 1.5;
     m_planetCount.textColor = Color(0.9843, 0.9490, 0.8039);
+
+    m_timer.onExpired([]() {
+        auto& o = Outrospection::get();
+        ((GUICharacterMaker*)o.layerPtrs["characterMaker"])->moveOutOfTheWay();
+        o.audioManager.play("timesUp");
+
+        Util::doLater([&o] () {
+            std::cout << "Time's up!" << std::endl;
+
+            ((GUIPostGame*)o.layerPtrs["postGame"])->start(((GUIPeople*)o.layerPtrs["people"])->humanCount() >= 50);
+        }, 4000);
+    });
 }
 
 GUIStats::~GUIStats()
@@ -44,6 +58,12 @@ void GUIStats::setTimer(time_t millis)
 
 void GUIStats::setPeopleCount(int count)
 {
+    // only rebuild the text when the number actually changed
+    if(count == m_shownPeopleCount)
+        return;
+
+    m_shownPeopleCount = count;
+
     using namespace std;
     stringstream ss;
     ss << 'x' << setfill('0') << setw(2) << count;
@@ -53,8 +73,6 @@ void GUIStats::setPeopleCount(int count)
 
 void GUIStats::tick()
 {
-    m_timer.tick();
-
     m_timerBlurTop.tick();
     m_bossIsBack.tick();
     m_timerDisplay.tick();
@@ -69,21 +87,6 @@ void GUIStats::tick()
     ss << setfill('0') << setw(2) << m_timer.getMinutes() << ":" << setw(2) << m_timer.getSeconds();
 
     m_timerDisplay.text = ss.str();
-
-    if(m_timer.ended()) {
-        m_timer.start();
-        m_timer.pause();
-
-        auto& o = Outrospection::get();
-        ((GUICharacterMaker*)o.layerPtrs["characterMaker"])->moveOutOfTheWay();
-        o.audioManager.play("timesUp");
-
-        Util::doLater([&o] () {
-            std::cout << "Time's up!" << std::endl;
-
-            ((GUIPostGame*)o.layerPtrs["postGame"])->start(((GUIPeople*)o.layerPtrs["people"])->humanCount() >= 50);
-        }, 4000);
-    }
 }
 
 void GUIStats::draw() const
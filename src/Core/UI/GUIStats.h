@@ -26,6 +26,7 @@ private:
     UIComponent m_timerBlurTop;
 
     UIComponent m_peopleCount;
+    int m_shownPeopleCount = -1;
     UIComponent m_peopleIcon;
 
     UIComponent m_planetCount;
@@ -0,0 +1,91 @@
+#include "TextLayout.h"
+
+#include "Outrospection.h"
+
+bool TextLayout::update(const std::string& text, float textSize, bool textShadow, const glm::vec2& componentSize,
+                        const glm::vec2& sizeRatio, const glm::vec2& fbResolution)
+{
+    if (text == m_text && textSize == m_textSize && textShadow == m_textShadow &&
+        componentSize == m_componentSize && fbResolution == m_fbResolution)
+        return false;
+
+    m_text = text;
+    m_textSize = textSize;
+    m_textShadow = textShadow;
+    m_componentSize = componentSize;
+    m_fbResolution = fbResolution;
+
+    rebuild(sizeRatio);
+
+    return true;
+}
+
+const std::vector<TextLayout::GlyphQuad>& TextLayout::getQuads() const
+{
+    return m_quads;
+}
+
+glm::vec2 TextLayout::getTextOffset() const
+{
+    return m_textOffset;
+}
+
+GLuint TextLayout::getAtlas() const
+{
+    return m_atlas;
+}
+
+void TextLayout::rebuild(const glm::vec2& sizeRatio)
+{
+    m_quads.clear();
+
+    const auto& fontCharacters = Outrospection::get().fontCharacters;
+
+    glm::vec2 textScale = sizeRatio * 1.5f * m_textSize; // TODO sketchy scale?
+
+    glm::vec2 textPos = glm::vec2(0);
+    textPos.y += (m_componentSize.y) / 2 + (10 * textScale.y);
+
+    // add an artificial space at the beginning
+    textPos.x += textScale.x * 10;
+
+    glm::vec2 startPos = textPos;
+
+    for (char c : m_text)
+    {
+        if (c <= '\0' || c == ' ')
+        {
+            textPos.x += textScale.x * 10;
+            continue;
+        }
+
+        if(c == '\n') {
+            startPos.y += m_componentSize.y / 2 * m_textSize;
+            textPos = startPos;
+            continue;
+        }
+
+        const auto f = fontCharacters.find(c);
+        if (f == fontCharacters.end()) {
+            LOG_ERROR("Character %c not found!", c);
+
+            // assume a space
+            textPos.x += textScale.x * 10;
+            continue;
+        }
+
+        const FontCharacter& fontCharacter = f->second;
+        m_atlas = fontCharacter.textureId;
+
+        glm::vec2 charPos = textPos;
+        charPos.x += fontCharacter.bearing.x * textScale.x;
+        charPos.y -= fontCharacter.bearing.y * textScale.y;
+
+        m_quads.push_back({ charPos, fontCharacter.size * textScale, fontCharacter.uv });
+
+        textPos.x += (fontCharacter.advance >> 6) * textScale.x;
+    }
+
+    // the text sits a bit above its shadow
+    m_textOffset = glm::vec2(0, (m_componentSize.y) / 16 * (textScale.y / 3.5f));
+}
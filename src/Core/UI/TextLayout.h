@@ -0,0 +1,47 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#ifdef USE_GLFM
+#include "glfm.h"
+#else
+#include <glad/glad.h>
+#endif
+
+#include <glm.hpp>
+
+// Glyph quads of a string, laid out relative to the top left of the component that owns it.
+// Only rebuilt when something the layout depends on changes, so static labels cost nothing per frame.
+class TextLayout
+{
+public:
+    struct GlyphQuad
+    {
+        glm::vec2 pos; // position of the shadow, the text itself is drawn at pos - textOffset
+        glm::vec2 size;
+        glm::vec4 uv;
+    };
+
+    // returns true if the layout had to be rebuilt
+    bool update(const std::string& text, float textSize, bool textShadow, const glm::vec2& componentSize,
+                const glm::vec2& sizeRatio, const glm::vec2& fbResolution);
+
+    const std::vector<GlyphQuad>& getQuads() const;
+    glm::vec2 getTextOffset() const;
+    GLuint getAtlas() const;
+
+private:
+    void rebuild(const glm::vec2& sizeRatio);
+
+    // the inputs the current layout was built from
+    std::string m_text;
+    float m_textSize = -1;
+    bool m_textShadow = false;
+    glm::vec2 m_componentSize = glm::vec2(0);
+    glm::vec2 m_fbResolution = glm::vec2(0);
+
+    std::vector<GlyphQuad> m_quads;
+    glm::vec2 m_textOffset = glm::vec2(0);
+    GLuint m_atlas = 0;
+};
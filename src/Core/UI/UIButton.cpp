@@ -36,13 +36,17 @@ bool UIButton::isOnButton(const glm::vec2& point) const
 
 void UIButton::tick()
 {
+    auto& o = Outrospection::get();
+
+    transform.beginTick();
+
     if(glm::length(m_goal) != 0 && transform.getPos() != m_goal)
     {
-        transform.setPos(Util::lerp(transform.getPos(), m_goal, 0.01));
-        buttonBounds.transform.setPos(Util::lerp(buttonBounds.transform.getPos(), m_goal, 0.01));
-    }
+        const float lerpFactor = o.perTickLerp(0.01f);
 
-    auto& o = Outrospection::get();
+        transform.setPos(Util::lerp(transform.getPos(), m_goal, lerpFactor));
+        buttonBounds.transform.setPos(Util::lerp(buttonBounds.transform.getPos(), m_goal, lerpFactor));
+    }
 
     glm::vec2 mousePos = o.lastMousePos;
 
@@ -32,6 +32,8 @@ UITransform::UITransform(int posX, int posY, int sizeX, int sizeY,
         pos -= size;
         break;
     }
+
+    prevPos = pos;
 }
 
 UITransform::UITransform(int posX, int posY, int radius,
@@ -43,6 +45,11 @@ glm::vec2 UITransform::getPos() const
     return pos * getSizeRatio();
 }
 
+glm::vec2 UITransform::getDrawPos() const
+{
+    return Util::lerp(prevPos, pos, Outrospection::get().getTickAlpha()) * getSizeRatio();
+}
+
 glm::vec2 UITransform::getSize() const
 {
     return size * getSizeRatio();
@@ -68,7 +75,15 @@ void UITransform::setSize(int x, int y)
     size = glm::vec2(x, y);
 }
 
-GLuint UIComponent::quadVAO = 0;
+void UITransform::beginTick()
+{
+    prevPos = pos;
+}
+
+void UITransform::snap()
+{
+    prevPos = pos;
+}
 
 UIComponent::UIComponent(const std::string& _texName, const GLint& texFilter, const UITransform& _transform)
     : UIComponent(_texName, simpleTexture({"ObjectData/UI/", _texName}, texFilter), _transform)
@@ -78,75 +93,107 @@ UIComponent::UIComponent(const std::string& _texName, const GLint& texFilter, co
 UIComponent::UIComponent(std::string _name, const Resource& _res, const UITransform& _transform)
     : text(std::move(_name)), textColor(0.0f), transform(_transform)
 {
-    animations.insert(std::make_pair("default", _res));
-
-    // we need to create our quad the first time!
-    if (quadVAO == 0)
-    {
-        // configure VAO/VBO
-        GLuint VBO;
-        float vertices[] = {
-            0.0f, 1.0f,
-            1.0f, 0.0f,
-            0.0f, 0.0f,
-
-            0.0f, 1.0f,
-            1.0f, 1.0f,
-            1.0f, 0.0f,
-        };
-
-        glGenVertexArrays(1, &quadVAO);
-        glGenBuffers(1, &VBO);
-
-        glBindBuffer(GL_ARRAY_BUFFER, VBO);
-        glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
-
-        glBindVertexArray(quadVAO);
-        glEnableVertexAttribArray(0);
-        glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), nullptr);
-        glBindBuffer(GL_ARRAY_BUFFER, 0);
-        glBindVertexArray(0);
-    }
+    addAnimation(Animations::DEFAULT, _res);
 }
 
 void UIComponent::tick()
 {
+    transform.beginTick();
+
+    const Outrospection& o = Outrospection::get();
+    const float lerpFactor = o.perTickLerp(animationSpeed);
+
     if(glm::length(m_goal) != 0 && transform.getPos() != m_goal)
     {
         if(moveLinearly)
-            transform.setPos(transform.getPos() + (2 * glm::normalize(m_goal - transform.getPos())));
+            transform.setPos(transform.getPos() + (o.perTick(2) * glm::normalize(m_goal - transform.getPos())));
         else
-            transform.setPos(Util::lerp(transform.getPos(), m_goal, animationSpeed));
+            transform.setPos(Util::lerp(transform.getPos(), m_goal, lerpFactor));
     }
 
-    opacity = Util::lerp(opacity, opacityGoal, animationSpeed);
+    opacity = Util::lerp(opacity, opacityGoal, lerpFactor);
 }
 
 void UIComponent::addAnimation(const std::string& anim, const Resource& _res)
 {
-    animations.insert(std::make_pair(anim, _res));
+    addAnimation(Animations::intern(anim), _res);
+}
+
+void UIComponent::addAnimation(AnimationId anim, const Resource& res)
+{
+    for(int i = 0; i < m_animationCount; i++)
+    {
+        // first one wins, like it did when these were kept in a map
+        if(m_animations[i].id == anim)
+            return;
+    }
+
+    if(m_animationCount == MAX_ANIMATIONS)
+    {
+        LOG_ERROR("Too many animations on %s, can't add %s!", text, Animations::name(anim));
+        return;
+    }
+
+    m_animations[m_animationCount++] = { anim, res, nullptr };
 }
 
 void UIComponent::setAnimation(const std::string& anim)
 {
-    Outrospection::get().textureManager.get(animations.at(curAnimation)).shouldTick = false;
-    Outrospection::get().textureManager.get(animations.at(curAnimation)).reset();
+    setAnimation(Animations::intern(anim));
+}
+
+void UIComponent::setAnimation(AnimationId anim)
+{
+    SimpleTexture& oldTex = animationTexture(m_curAnimation);
+    oldTex.shouldTick = false;
+    oldTex.reset();
+
+    int index = -1;
+    for(int i = 0; i < m_animationCount; i++)
+    {
+        if(m_animations[i].id == anim)
+        {
+            index = i;
+            break;
+        }
+    }
 
-    if(animations.find(anim) == animations.end())
+    if(index == -1)
     {
-        LOG_ERROR("Animation %s has not been loaded!", anim);
-        curAnimation = "default";
+        LOG_ERROR("Animation %s has not been loaded!", Animations::name(anim));
+        m_curAnimation = 0;
     } else {
-        curAnimation = anim;
+        m_curAnimation = index;
     }
 
-    Outrospection::get().textureManager.get(animations.at(curAnimation)).reset();
-    Outrospection::get().textureManager.get(animations.at(curAnimation)).shouldTick = true;
+    SimpleTexture& newTex = animationTexture(m_curAnimation);
+    newTex.reset();
+    newTex.shouldTick = true;
+}
+
+AnimationId UIComponent::getAnimation() const
+{
+    return m_animations[m_curAnimation].id;
+}
+
+bool UIComponent::animationDone() const
+{
+    return animationTexture(m_curAnimation).finished();
+}
+
+SimpleTexture& UIComponent::animationTexture(int index) const
+{
+    const Animation& animation = m_animations[index];
+    if(!animation.texture)
+        animation.texture = &Outrospection::get().textureManager.get(animation.resource);
+
+    return *animation.texture;
 }
 
 void UIComponent::setPosition(int x, int y)
 {
     transform.setPos(x, y);
+    transform.snap();
 }
 
 void UIComponent::setScale(int px)
@@ -164,33 +211,20 @@ void UIComponent::draw(Shader& shader, const Shader& glyphShader) const
     if (!visible)
         return;
 
-    shader.use();
-
-    glm::vec2 pos = transform.getPos();
+    glm::vec2 pos = transform.getDrawPos();
 
     if(bobUpAndDown)
     {
-        pos.y += transform.getSize().y * 0.1f * sin((Util::currentTimeMillis() % 100000) / 1000.f + float(Util::hashBytes(text.c_str(), text.length()) % 10000) / 100.f);
-
-        //printf("%f\n", Util::currentTimeMillis() % 100000);
+        pos.y += transform.getSize().y * 0.1f * sin((Outrospection::get().clock.nowMillis() % 100000) / 1000.f + float(Util::hashBytes(text.c_str(), text.length()) % 10000) / 100.f);
     }
 
-    // TODO maybe we should cache this
-    glm::mat4 model = glm::mat4(1.0f);
-    model = glm::translate(model, glm::vec3(pos, 0));
-    model = glm::scale(model, glm::vec3(transform.getSize(), 0));
-
-    shader.setMat4("model", model);
+    const SimpleTexture& tex = animationTexture(m_curAnimation);
 
-    shader.setFloat("opacity", opacity);
-    shader.setBool("flip", flip);
-
-    glActiveTexture(GL_TEXTURE0);
-    Outrospection::get().textureManager.get(animations.at(curAnimation)).bind();
-
-    glBindVertexArray(quadVAO);
-    glDrawArrays(GL_TRIANGLES, 0, 6);
-    glBindVertexArray(0);
+    // fully transparent, no need to draw anything
+    if (!(tex == TextureManager::None))
+    {
+        Outrospection::get().spriteBatch.submit(shader, tex.texId, pos, transform.getSize(), tex.getUV(flip), glm::vec4(1, 1, 1, opacity));
+    }
 
     if (textSize > 0 && !text.empty()) // TODO make a proper text class
     {
@@ -200,82 +234,23 @@ void UIComponent::draw(Shader& shader, const Shader& glyphShader) const
 
 void UIComponent::drawText(const std::string& text, const Shader& glyphShader) const
 {
-    glyphShader.use();
-    glActiveTexture(GL_TEXTURE0);
-    glBindVertexArray(quadVAO);
-
-    glm::vec2 textScale = transform.getSizeRatio() * 1.5f * textSize; // TODO sketchy scale?
+    m_textLayout.update(text, textSize, textShadow, transform.getSize(), transform.getSizeRatio(),
+                        *Outrospection::get().curFbResolution);
 
-    glm::vec2 textPos = transform.getPos();
-    textPos.y += (transform.getSize().y) / 2 + (10 * textScale.y);
+    // every glyph lives in the same atlas, so the whole string (shadow included) ends up in one batch
+    SpriteBatch& batch = Outrospection::get().spriteBatch;
+    const glm::vec2 pos = transform.getDrawPos();
+    const GLuint atlas = m_textLayout.getAtlas();
 
-    // add an artificial space at the beginning
-    textPos.x += textScale.x * 10;
-
-    glm::vec2 startPos = textPos;
-
-    for (char c : text)
-    {
-        if (c <= '\0' || c == ' ')
-        {
-            textPos.x += textScale.x * 10;
-            continue;
-        }
-
-        if(c == '\n') {
-            startPos.y += transform.getSize().y / 2 * textSize;
-            textPos = startPos;
-            continue;
-        }
-
-        if (!Outrospection::get().fontCharacters.contains(c)) {
-            LOG_ERROR("Character %c not found!", c);
-
-            // assume a space
-            textPos.x += textScale.x * 10;
-            continue;
-        }
-
-        FontCharacter fontCharacter = Outrospection::get().fontCharacters[c];
-
-        // calculate model matrix
-        glm::mat4 charModel = glm::mat4(1.0f);
-
-        glm::vec2 charPos = textPos;
-        charPos.x += fontCharacter.bearing.x * textScale.x;
-        charPos.y -= fontCharacter.bearing.y * textScale.y;
-
-        glm::vec2 charSize = fontCharacter.size * textScale;
-
-
-        glBindTexture(GL_TEXTURE_2D, fontCharacter.textureId);
-
-        if(textShadow) {
-            charModel = glm::translate(charModel, glm::vec3(charPos, 0.0f));
-            charModel = glm::scale(charModel, glm::vec3(charSize, 1.0f));
-
-            glyphShader.setMat4("model", charModel);
-            glyphShader.setVec3("textColor", 0.765f * textColor);
-
-            glDrawArrays(GL_TRIANGLES, 0, 6);
-
-            charModel = glm::mat4(1.0f);
-        }
-
-        charPos.y -= (transform.getSize().y) / 16 * (textScale.y / 3.5f);
-
-        charModel = glm::translate(charModel, glm::vec3(charPos, 0.0f));
-        charModel = glm::scale(charModel, glm::vec3(charSize, 1.0f));
-
-        glyphShader.setMat4("model", charModel);
-        glyphShader.setVec3("textColor", textColor);
-
-        glDrawArrays(GL_TRIANGLES, 0, 6);
-
-        textPos.x += (fontCharacter.advance >> 6) * textScale.x;
+    if(textShadow) {
+        for (const TextLayout::GlyphQuad& quad : m_textLayout.getQuads())
+            batch.submit(glyphShader, atlas, pos + quad.pos, quad.size, quad.uv, glm::vec4(0.765f * textColor, 1.0f));
     }
 
-    glBindVertexArray(0);
+    const glm::vec2 textPos = pos - m_textLayout.getTextOffset();
+
+    for (const TextLayout::GlyphQuad& quad : m_textLayout.getQuads())
+        batch.submit(glyphShader, atlas, textPos + quad.pos, quad.size, quad.uv, glm::vec4(textColor, 1.0f));
 }
 
 void UIComponent::setGoal(int x, int y)
@@ -291,7 +266,10 @@ bool UIComponent::hasGoal()
 void UIComponent::warpToGoal()
 {
     if(glm::length(m_goal) > 0)
+    {
         transform.setPos(m_goal);
+        transform.snap();
+    }
 
     opacity = opacityGoal;
 }
@@ -1,4 +1,5 @@
 #pragma once
+#include <array>
 #include <string>
 
 #include <vec2.hpp>
@@ -6,6 +7,8 @@
 #include "Outrospection.h"
 #include "Core/Rendering/SimpleTexture.h"
 #include "Core/Rendering/TextureManager.h"
+#include "AnimationId.h"
+#include "TextLayout.h"
 
 class Shader;
 
@@ -24,6 +27,9 @@ class UITransform
 
     glm::vec2 pos;
     glm::vec2 size;
+
+    // position before the latest tick, drawn positions are interpolated from it
+    glm::vec2 prevPos;
 public:
     // units are in 1080p pixels
     UITransform(int posX, int posY, int sizeX, int sizeY,
@@ -37,9 +43,18 @@ public:
     glm::vec2 getSize() const;
     glm::vec2 getSizeRatio() const;
 
+    // position to draw at, between the previous tick and the latest one
+    glm::vec2 getDrawPos() const;
+
     void setPos(glm::vec2 _pos);
     void setPos(int x, int y);
     void setSize(int x, int y);
+
+    // call at the start of every tick, before moving
+    void beginTick();
+    // jump to the current position without interpolating from the previous one
+    void snap();
+
     UIAlign alignment;
 };
 
@@ -54,7 +69,11 @@ public:
     virtual void tick();
 
     void addAnimation(const std::string& anim, const Resource& _res);
+    void addAnimation(AnimationId anim, const Resource& res);
     void setAnimation(const std::string& anim);
+    void setAnimation(AnimationId anim);
+    AnimationId getAnimation() const;
+    bool animationDone() const;
 
     void setPosition(int x, int y);
     void setScale(int px);
@@ -84,12 +103,27 @@ public:
 protected:
     UITransform transform;
 
-    static GLuint quadVAO;
-
     virtual void drawText(const std::string& text, const Shader& glyphShader) const;
 
-    std::string curAnimation = "default";
-    std::unordered_map<std::string, Resource> animations;
+    // rebuilt by drawText when the text or anything affecting its layout changes
+    mutable TextLayout m_textLayout;
+
+    static constexpr int MAX_ANIMATIONS = 8;
+
+    struct Animation
+    {
+        AnimationId id = Animations::DEFAULT;
+        Resource resource;
+        mutable SimpleTexture* texture = nullptr; // looked up on first use
+    };
+
+    // the animation's texture, without going through TextureManager's map every time
+    SimpleTexture& animationTexture(int index) const;
+
+    // index 0 is the default animation
+    std::array<Animation, MAX_ANIMATIONS> m_animations;
+    int m_animationCount = 0;
+    int m_curAnimation = 0;
 
     glm::vec2 m_goal = glm::vec2(0);
 
@@ -2,19 +2,12 @@
 
 UIHuman::UIHuman(const UITransform& transform) : UIComponent("Human base", Resource(), transform)
 {
-    m_deletionTimer.pause();
-    m_obliterationTimer.pause();
-}
-
-void UIHuman::addToLayer(HumanLayer name, const Resource& resource, bool bad)
-{
-    m_layers[int(name)].push_back(resource);
-    m_layerBad[int(name)].push_back(bad);
-}
+    const CostumeCatalog& catalog = Outrospection::get().costumeCatalog;
 
-void UIHuman::addToLayer(HumanLayer name, const std::string& textureName, bool bad)
-{
-    addToLayer(name, simpleTexture({"CostumeData/", textureName}, GL_LINEAR), bad);
+    for(int i = 0; i < m_order.size(); i++) {
+        for(size_t part = 0; part < catalog.partCount(i); part++)
+            m_order[i].push_back(uint8_t(part));
+    }
 }
 
 void UIHuman::draw(Shader& shader, const Shader&) const
@@ -22,67 +15,34 @@ void UIHuman::draw(Shader& shader, const Shader&) const
     if (!visible)
         return;
 
-    shader.use();
-
-    // TODO maybe we should cache this
-    glm::mat4 model = glm::mat4(1.0f);
-
-    model = glm::translate(model, glm::vec3(transform.getPos(), 0));
-    model = glm::scale(model, glm::vec3(transform.getSize(), 0));
+    SpriteBatch& batch = Outrospection::get().spriteBatch;
 
-    shader.setMat4("model", model);
+    const glm::vec2 pos = transform.getDrawPos();
+    const glm::vec2 size = transform.getSize();
 
+    if(getAnimation() == Animations::DEFAULT) {
+        // all five layers composited once, then drawn as one sprite
+        const SimpleTexture tex = Outrospection::get().costumeCache.get(getCostume());
 
-    glActiveTexture(GL_TEXTURE0);
-    glBindVertexArray(quadVAO);
+        // face the direction we're walking in
+        const bool flip = m_goal.x > pos.x;
 
-    if(curAnimation == "default") {
-        shader.setBool("flip", m_goal.x > transform.getPos().x);
-
-        for(int i = 0; i < m_layers.size(); i++)
-        {
-            Resource layer = m_layers[i].operator[](m_curLayer[i]);
-
-            if(layer.empty())
-                continue;
-
-            Outrospection::get().textureManager.get(layer).bind();
-
-            glDrawArrays(GL_TRIANGLES, 0, 6);
-        }
+        batch.submit(Outrospection::get().shaders["costume"], tex.texId, pos, size, tex.getUV(flip), glm::vec4(1, 1, 1, opacity));
     } else {
-        Outrospection::get().textureManager.get(animations.at(curAnimation)).bind();
-        glDrawArrays(GL_TRIANGLES, 0, 6);
-    }
+        const SimpleTexture& tex = animationTexture(m_curAnimation);
 
-    shader.setBool("flip", false);
-
-    glBindVertexArray(0);
+        if(!(tex == TextureManager::None))
+            batch.submit(shader, tex.texId, pos, size, tex.getUV(), glm::vec4(1, 1, 1, opacity));
+    }
 }
 
 void UIHuman::tick()
 {
-    if(!isDead() && glm::length(m_goal) != 0 && transform.getPos() != m_goal) {
+    transform.beginTick();
 
-        transform.setPos(Util::lerp(transform.getPos(), m_goal, 0.01));
-    }
-
-    m_deletionTimer.tick();
-    if(m_deletionTimer.ended())
-    {
-        m_deletionTimer.start();
-        m_deletionTimer.pause();
-
-        explode();
-    }
+    if(glm::length(m_goal) != 0 && transform.getPos() != m_goal) {
 
-    m_obliterationTimer.tick();
-    if(m_obliterationTimer.ended())
-    {
-        m_obliterationTimer.start();
-        m_obliterationTimer.pause();
-
-        setAnimation("dead");
+        transform.setPos(Util::lerp(transform.getPos(), m_goal, Outrospection::get().perTickLerp(0.01f)));
     }
 }
 
@@ -93,62 +53,36 @@ void UIHuman::changeLayer(HumanLayer layer, int delta)
 
     // wrap around
     if(m_curLayer[int(layer)] < 0)
-        m_curLayer[int(layer)] = m_layers[int(layer)].size() - 1;
+        m_curLayer[int(layer)] = m_order[int(layer)].size() - 1;
 
-    if(m_curLayer[int(layer)] >= m_layers[int(layer)].size())
+    if(m_curLayer[int(layer)] >= m_order[int(layer)].size())
         m_curLayer[int(layer)] = 0;
 }
 
-void UIHuman::rollTheDice()
+void UIHuman::rollTheDice(Random& random)
 {
-    for(int i = 0; i < m_layers.size(); i++) {
-        float random = rand() / float(RAND_MAX) * m_layers[i].size();
-
-        m_curLayer[i] = random;
+    for(int i = 0; i < m_order.size(); i++) {
+        m_curLayer[i] = random.below(m_order[i].size());
 
-        for(int k = 0; k < m_layers[i].size(); k++) {
-            int r = k + rand() % (m_layers[i].size() - k);
+        for(int k = 0; k < m_order[i].size(); k++) {
+            int r = k + random.below(m_order[i].size() - k);
 
-            Resource temp = m_layers[i][k];
-            m_layers[i][k] = m_layers[i][r];
-            m_layers[i][r] = temp;
-
-            bool temp2 = m_layerBad[i][k];
-            m_layerBad[i][k] = m_layerBad[i][r];
-            m_layerBad[i][r] = temp2;
+            std::swap(m_order[i][k], m_order[i][r]);
         }
     }
 }
 
-bool UIHuman::isBad()
-{
-    for(int i = 0; i < m_layers.size(); i++) {
-        if(m_layerBad[i][m_curLayer[i]])
-            return true;
-    }
-
-    return false;
-}
-
-bool UIHuman::isDead()
+CostumeCatalog::Costume UIHuman::getCostume() const
 {
-   return (curAnimation == "dead") || (curAnimation == "exploding");
-}
+    CostumeCatalog::Costume costume;
+    for(int i = 0; i < m_order.size(); i++)
+        costume.parts[i] = m_order[i][m_curLayer[i]];
 
-void UIHuman::markForDeletion()
-{
-    m_deletionTimer.setDuration(2000);
-    m_deletionTimer.start();
+    return costume;
 }
 
-void UIHuman::explode(bool silent)
+bool UIHuman::isBad() const
 {
-    setAnimation("exploding");
-    setScale(200, 200);
-
-    if(!silent)
-        Outrospection::get().audioManager.play("explode", 0.5);
-
-    m_obliterationTimer.setDuration(300);
-    m_obliterationTimer.start();
+    const CostumeCatalog& catalog = Outrospection::get().costumeCatalog;
+    return catalog.isBad(getCostume());
 }
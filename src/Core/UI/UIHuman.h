@@ -1,16 +1,8 @@
 #pragma once
 
 #include "UIComponent.h"
-#include <Timer.h>
-
-enum class HumanLayer
-{
-    FACE    = 0,
-    LEGS    = 1,
-    TORSO   = 2,
-    HAT     = 3,
-    HANDS   = 4,
-};
+#include "Core/CostumeCatalog.h"
+#include "Core/Random.h"
 
 class UIHuman : public UIComponent
 {
@@ -20,23 +12,16 @@ public:
     void draw(Shader& shader = Outrospection::get().shaders["sprite"], const Shader& = Outrospection::get().shaders["glyph"]) const override;
     void tick() override;
 
-    void addToLayer(HumanLayer name, const Resource& resource, bool bad = false);
-    void addToLayer(HumanLayer name, const std::string& textureName, bool bad = false);
-
     void changeLayer(HumanLayer layer, int delta);
 
-    void rollTheDice();
-
-    bool isBad();
-    bool isDead();
+    void rollTheDice(Random& random);
 
-    void markForDeletion();
-    void explode(bool silent = false);
+    // the parts currently picked
+    CostumeCatalog::Costume getCostume() const;
+    bool isBad() const;
 
 private:
-    std::array<std::vector<Resource>, 5> m_layers;
-    std::array<int, 5> m_curLayer = { 0, 0, 0, 0, 0 };
-    std::array<std::vector<bool>, 5> m_layerBad;
-
-    Timer m_deletionTimer, m_obliterationTimer;
+    // the catalog's parts of every layer, in the order the arrows go through them. Shuffled by rollTheDice
+    std::array<std::vector<uint8_t>, CostumeCatalog::LAYER_COUNT> m_order;
+    std::array<int, CostumeCatalog::LAYER_COUNT> m_curLayer = { 0, 0, 0, 0, 0 };
 };
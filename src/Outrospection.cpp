@@ -1,5 +1,7 @@
 ﻿#include "Outrospection.h"
 
+#include <algorithm>
+#include <cmath>
 #include <iostream>
 #include <fstream>
 #include <chrono>
@@ -18,6 +20,8 @@
 #endif
 
 #include "Util.h"
+#include "Core/Random.h"
+#include "Core/Rendering/GLState.h"
 #include "Core/Layer.h"
 
 #include "Core/UI/GUILayer.h"
@@ -45,8 +49,7 @@ Outrospection::Outrospection()
 
     LOG("Initializing engine...");
 
-    // seed rand()
-    srand(time(nullptr));
+    LOG_INFO("Random seed: %llu (pass --seed to replay this run)", (unsigned long long) RandomStreams::getSeed());
 
     // TODO emscripten doesn't like this
     // loggerThread.start();
@@ -73,8 +76,16 @@ Outrospection::Outrospection()
 #endif
     createShaders();
 
+#ifndef USE_GLFM
+    // OpenGL turns vsync on, let the frame pacer know
+    setVsync(true);
+#endif
+
     setCursor("default");
 
+    // the character maker and the crowd both need it
+    costumeCatalog.load();
+
     layerPtrs["tutorial"] = new GUITutorial();
     layerPtrs["background"] = new GUIBackground();
     layerPtrs["characterMaker"] = new GUICharacterMaker();
@@ -101,7 +112,8 @@ Outrospection::Outrospection()
 
     updateResolution(width, height);
 
-    lastFrame = Util::currentTimeMillis();
+    // don't count loading as time that passed in game
+    clock.resync();
 }
 
 Outrospection::~Outrospection()
@@ -131,15 +143,14 @@ void Outrospection::stop()
 
 void Outrospection::run()
 {
-    using namespace std::chrono_literals;
-
     running = true;
 
-    lastFrame = Util::currentTimeMillis(); // I miss java
-    deltaTime = 1.0f / 60.0f;
+    clock.resync();
 
     // GLFM calls this by itself
 #ifndef USE_GLFM
+    framePacer.reset();
+
     while (running)
     {
         runGameLoop();
@@ -147,16 +158,8 @@ void Outrospection::run()
         if (glfwWindowShouldClose(gameWindow))
             running = false;
 
-        currentTimeMillis = Util::currentTimeMillis();
-        time_t frameTime = currentTimeMillis - lastFrame;
-
-        // sleep for any extra time we have
-        auto extraTime = 16 - frameTime;
-
-        if(extraTime > 0) {
-            auto m = std::chrono::milliseconds(extraTime - 1);
-            std::this_thread::sleep_for(m);
-        }
+        // wait out whatever is left of this frame
+        framePacer.wait();
     }
 #endif
 }
@@ -223,7 +226,7 @@ void Outrospection::captureMouse(const bool doCapture)
 
 void Outrospection::scheduleWorldTick()
 {
-    lastTick = Util::currentTimeMillis() - 5000;
+    lastTick = clock.tickNowMillis() - 5000;
 }
 
 #ifndef USE_GLFM
@@ -255,53 +258,51 @@ void Outrospection::toggleFullscreen()
 
     isFullscreen = !isFullscreen;
 }
+
+void Outrospection::setVsync(bool vsync)
+{
+    const int interval = vsync ? 1 : 0;
+    glfwSwapInterval(interval);
+
+    const GLFWvidmode* mode = glfwGetVideoMode(glfwGetPrimaryMonitor());
+    framePacer.setSwapInterval(interval, mode ? mode->refreshRate : 0);
+}
 #endif
 
 void Outrospection::runGameLoop()
 {
-    currentTimeMillis = Util::currentTimeMillis();
-    deltaTime = float(currentTimeMillis - lastFrame) / 1000.0f;
-    lastFrame = currentTimeMillis;
+    // everything reads the time sampled here until the next frame
+    clock.beginFrame();
 
+    // fetch input into simplified controller class
+    updateInput();
 
-    // Update game world
-    {
-        // fetch input into simplified controller class
-        updateInput();
+    // Update game world in fixed steps, so the simulation runs at the same speed at any frame rate.
+    // A long frame (e.g. dragging the window) is clamped so we don't try to catch up on all of it
+    // while paused, game time stands still but the UI keeps ticking in real time
+    tickAccumulator += clock.isPaused() ? clock.realDeltaSeconds() : clock.deltaSeconds();
 
-        if (!isGamePaused)
-        {
-            // Run one "tick" of the game physics
-            runTick();
-            textureManager.tickAllTextures();
+    int ticksThisFrame = 0;
+    while (tickAccumulator >= tickLength && ticksThisFrame < MAX_TICKS_PER_FRAME)
+    {
+        runFixedTick();
 
-            // execute scheduled tasks
-            for(int i = 0; i < futureFunctions.size(); i++)
-            {
-                const auto& futureFunc = futureFunctions[i];
-                
-                if(currentTimeMillis - futureFunc.startTime > futureFunc.waitTime)
-                {
-                    futureFunc.func();
-
-                    // pop the function
-                    futureFunctions.erase(futureFunctions.begin() + i);
-                    i--;
-                }
-            }
-        }
-        
-        // UIs are also updated when game is paused
-        for (auto& layer : layerStack)
-        {
-            layer->tick();
-        }
+        tickAccumulator -= tickLength;
+        ticksThisFrame++;
     }
 
+    if (tickAccumulator >= tickLength) // fell behind, drop the backlog
+        tickAccumulator = std::fmod(tickAccumulator, tickLength);
+
+    // the frame is drawn this far between the last two ticks
+    tickAlpha = tickAccumulator / tickLength;
+
     // Draw the frame!
     {
         glDisable(GL_DEPTH_TEST); // disable depth test so stuff near camera isn't clipped
 
+        frameUniforms.setTime(float(clock.nowMillis() % 100000) / 1000.0f);
+
         framebuffers["default"].bind();
         glClear(GL_COLOR_BUFFER_BIT);
         
@@ -318,6 +319,8 @@ void Outrospection::runGameLoop()
             
             layer->draw();
         }
+
+        spriteBatch.flush();
     }
 
     // check for errors
@@ -331,14 +334,144 @@ void Outrospection::runGameLoop()
     glfwSwapBuffers(gameWindow);
     glfwPollEvents();
 #endif
+
+    spriteBatch.endFrame();
+    crowdRenderer.endFrame();
+    GLState::endFrame();
+    logFrameStats();
+}
+
+void Outrospection::logFrameStats()
+{
+    if (!showFrameStats || clock.realNowMillis() - lastFrameStatsLog < 1000)
+        return;
+
+    lastFrameStatsLog = clock.realNowMillis();
+
+    const SpriteBatch::Stats& stats = spriteBatch.lastFrameStats();
+    const CrowdRenderer::Stats& crowdStats = crowdRenderer.lastFrameStats();
+    LOG_INFO("Frame stats: %u draw calls, %u sprites, %u flushes, %u crowd humans in %u draw calls",
+             stats.drawCalls + crowdStats.drawCalls, stats.sprites, stats.flushes, crowdStats.humans, crowdStats.drawCalls);
+
+    const GLState::Stats& glStats = GLState::lastFrameStats();
+    LOG_INFO("GL state: %u calls issued, %u redundant calls skipped", glStats.issued, glStats.skipped);
+
+    const CostumeCache::Stats& costumeStats = costumeCache.getStats();
+    const unsigned int lookups = costumeStats.hits + costumeStats.misses;
+    LOG_INFO("Costume cache: %u/%u entries, %.1f%% hit rate (%u lookups, %u evictions), %.1f MB VRAM",
+             costumeStats.entries, costumeStats.capacity, lookups ? 100.0f * costumeStats.hits / lookups : 0.0f,
+             lookups, costumeStats.evictions, costumeStats.vramBytes / (1024.0f * 1024.0f));
+
+#ifndef USE_GLFM
+    const FramePacer::Stats pacerStats = framePacer.getStats();
+    LOG_INFO("Frame pacing: %u frames, %.2f ms average, %.2f ms worst, %u missed deadlines, %.1f ms spent spinning",
+             pacerStats.frames, pacerStats.averageFrameMs, pacerStats.worstFrameMs, pacerStats.missedDeadlines, pacerStats.spinMs);
+    framePacer.resetStats();
+#endif
+
+    // one line for all workers, so many-core machines don't flood the log
+    const std::vector<JobSystem::WorkerStats> workerStats = jobSystem.getStats();
+    if (!workerStats.empty())
+    {
+        unsigned int jobs = 0, steals = 0;
+        float utilization = 0, busiest = 0;
+        for (const JobSystem::WorkerStats& worker : workerStats)
+        {
+            jobs += worker.jobs;
+            steals += worker.steals;
+            utilization += worker.utilization;
+            busiest = std::max(busiest, worker.utilization);
+        }
+
+        LOG_INFO("Job system: %i workers, %.1f%% busy on average, %.1f%% the busiest, %u jobs, %u stolen", int(workerStats.size()),
+                 utilization / workerStats.size() * 100.0f, busiest * 100.0f, jobs, steals);
+    }
+    jobSystem.resetStats();
+}
+
+void Outrospection::runFixedTick()
+{
+    if (!clock.isPaused())
+    {
+        clock.beginTick(tickLength);
+
+        // Run one "tick" of the game physics
+        runTick();
+        textureManager.tickAllTextures();
+
+        // expire timers, then execute scheduled tasks
+        timerManager.tick();
+        scheduler.advance(clock.tickNowMillis());
+
+        // cutscenes can start other cutscenes, so don't hold on to references
+        const float tickMs = tickLength * 1000.0f;
+        for (size_t i = 0; i < cutscenes.size(); i++)
+            cutscenes[i].tick(tickMs);
+
+        std::erase_if(cutscenes, [](const Cutscene& cutscene) { return !cutscene.running(); });
+    }
+
+    // UIs are also updated when game is paused
+    for (auto& layer : layerStack)
+    {
+        layer->tick();
+    }
+}
+
+void Outrospection::playCutscene(Cutscene cutscene)
+{
+    cutscenes.push_back(std::move(cutscene));
+}
+
+void Outrospection::skipCutscenes()
+{
+    for (size_t i = 0; i < cutscenes.size(); i++)
+        cutscenes[i].skip();
+
+    std::erase_if(cutscenes, [](const Cutscene& cutscene) { return !cutscene.running(); });
+}
+
+void Outrospection::setTickRate(int ticksPerSecond)
+{
+    ticksPerSecond = std::clamp(ticksPerSecond, MIN_TICK_RATE, MAX_TICK_RATE);
+
+    // keep the render position between ticks where it was
+    const float alpha = tickAccumulator / tickLength;
+
+    tickRate = ticksPerSecond;
+    tickLength = 1.0f / float(tickRate);
+    tickAccumulator = alpha * tickLength;
+
+    LOG_INFO("Simulation running at %i ticks per second", tickRate);
+}
+
+int Outrospection::getTickRate() const
+{
+    return tickRate;
+}
+
+float Outrospection::getTickAlpha() const
+{
+    return tickAlpha;
+}
+
+float Outrospection::perTick(float baseAmount) const
+{
+    return baseAmount * float(BASE_TICK_RATE) / float(tickRate);
+}
+
+float Outrospection::perTickLerp(float baseFactor) const
+{
+    // applying the factor n times must cover the same distance as applying the base one BASE_TICK_RATE/n times
+    return 1.0f - std::pow(1.0f - baseFactor, float(BASE_TICK_RATE) / float(tickRate));
 }
 
 void Outrospection::runTick()
 {
-    if (currentTimeMillis - lastTick < 200) // five ticks per second
+    if (clock.tickNowMillis() - lastTick < 200) // five ticks per second
         return;
     
-    lastTick = currentTimeMillis;
+    lastTick = clock.tickNowMillis();
 
     //((GUIScene*)scene)->worldTick();
 }
@@ -351,6 +484,9 @@ void Outrospection::onFrame(GLFMDisplay* display)
 
 void Outrospection::onSurfaceCreated(GLFMDisplay* display, int width, int height)
 {
+    // a new surface can come with a fresh context
+    GLState::invalidate();
+
     Outrospection::get().updateResolution(width, height);
 }
 
@@ -511,9 +647,37 @@ void Outrospection::createShaders()
 {
     LOG_INFO("Setting up shaders...");
 
+    const time_t startTime = Util::currentTimeMillis();
+
     shaders.insert(std::make_pair("screen", Shader("screen", "screen")));
     shaders.insert(std::make_pair("sprite", Shader("sprite", "sprite")));
     shaders.insert(std::make_pair("glyph",  Shader("sprite", "glyph" )));
+    shaders.insert(std::make_pair("crowd",  Shader("crowd",  "crowd" )));
+    shaders.insert(std::make_pair("costume", Shader("sprite", "costume")));
+
+    // every draw binds its texture to unit 0
+    static constexpr Shader::Uniform screenTexture("screenTexture");
+    static constexpr Shader::Uniform image("image");
+    static constexpr Shader::Uniform glyph("glyph");
+    static constexpr Shader::Uniform layers("layers");
+
+    const std::pair<const char*, Shader::Uniform> samplers[] = {
+        { "screen", screenTexture }, { "sprite", image }, { "glyph", glyph }, { "crowd", layers }, { "costume", image }
+    };
+
+    for (const auto& [name, sampler] : samplers)
+    {
+        const Shader& shader = shaders[name];
+        shader.use();
+        shader.setInt(sampler, 0);
+    }
+
+    int cached = 0;
+    for (const auto& [name, shader] : shaders)
+        cached += shader.loadedFromCache;
+
+    LOG_INFO("Created %i shaders in %lli ms, %i of them from the binary cache",
+             int(shaders.size()), (long long) (Util::currentTimeMillis() - startTime), cached);
 }
 
 #ifndef USE_GLFM
@@ -631,10 +795,18 @@ bool Outrospection::onKeyPressed(KeyPressedEvent& e)
     case GLFW_KEY_ESCAPE:
         Outrospection::get().running = false;
         return true;
+    case GLFW_KEY_F6:
+        skipCutscenes();
+        return true;
 #endif
     case GLFW_KEY_F11:
         Outrospection::get().toggleFullscreen();
         return true;
+    case GLFW_KEY_F3:
+        showFrameStats = !showFrameStats;
+        framePacer.resetStats();
+        jobSystem.resetStats();
+        return true;
     }
 #endif
 
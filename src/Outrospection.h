@@ -13,10 +13,20 @@
 #include "Core/LayerStack.h"
 #include "Core/Registry.h"
 #include "Core/AudioManager.h"
+#include "Core/CostumeCatalog.h"
+#include "Core/Cutscene.h"
+#include "Core/GameClock.h"
+#include "TimerManager.h"
+#include "Core/FramePacer.h"
+#include "Core/JobSystem.h"
+#include "Core/Rendering/CostumeCache.h"
+#include "Core/Rendering/CrowdRenderer.h"
 #include "Core/Rendering/FreeType.h"
 #include "Core/Rendering/Framebuffer.h"
+#include "Core/Rendering/FrameUniforms.h"
 #include "Core/Rendering/OpenGL.h"
 #include "Core/Rendering/Shader.h"
+#include "Core/Rendering/SpriteBatch.h"
 #include "Core/Rendering/TextureManager.h"
 #include "Core/UI/GUILayer.h"
 
@@ -75,23 +85,52 @@ static bool onTouch(GLFMDisplay* display, int touch, GLFMTouchPhase phase, doubl
 
     void scheduleWorldTick(); // tick world NOW
 
+    // run a cutscene alongside the simulation until its script returns
+    void playCutscene(Cutscene cutscene);
+    // run every playing cutscene to its end right away
+    void skipCutscenes();
+
     void toggleFullscreen();
+    void setVsync(bool vsync);
 
     void setResolution(glm::vec2 res);
     void updateResolution(int x, int y);
     glm::vec2 getWindowResolution() const;
 
+    // fixed simulation rate in ticks per second. Rendering interpolates between ticks, so lower rates
+    // trade smoothness of the simulation for CPU time without slowing the game down
+    void setTickRate(int ticksPerSecond);
+    int getTickRate() const;
+
+    // how far the current frame is between the previous tick and the latest one, from 0 to 1
+    float getTickAlpha() const;
+
+    // scale per-tick amounts tuned at BASE_TICK_RATE to the current tick rate
+    float perTick(float baseAmount) const;      // for linear steps
+    float perTickLerp(float baseFactor) const;  // for lerp factors
+
     void setWindowText(const std::string& text) const;
     void setCursor(const std::string& cursorName);
 
+    Framebuffer* curFramebuffer = nullptr;
     glm::ivec2* curFbResolution = &curWindowResolution;
 
     glm::vec2 lastMousePos = glm::vec2(curWindowResolution / 2);
 
+    GameClock clock;
+    TimerManager timerManager = TimerManager(clock);
+    FramePacer framePacer;
+    JobSystem jobSystem;
     TextureManager textureManager;
     AudioManager audioManager;
-
-	std::vector<Util::FutureRun> futureFunctions;
+    FrameUniforms frameUniforms;
+    SpriteBatch spriteBatch;
+    CrowdRenderer crowdRenderer;
+    CostumeCatalog costumeCatalog;
+    CostumeCache costumeCache;
+
+    Scheduler scheduler;
+    std::vector<Cutscene> cutscenes;
     std::unordered_map<char, FontCharacter> fontCharacters;
 
     std::unordered_map<std::string, Shader> shaders;
@@ -100,19 +139,30 @@ static bool onTouch(GLFMDisplay* display, int touch, GLFMTouchPhase phase, doubl
 
     bool won = false;
 
-    time_t currentTimeMillis = 0;
-
     DISALLOW_COPY_AND_ASSIGN(Outrospection);
 private:
     void runTick();
     time_t lastTick = 0;
 
+    // one fixed step of the simulation, run tickRate times per second by runGameLoop
+    void runFixedTick();
+
+    int tickRate = DEFAULT_TICK_RATE;
+    float tickLength = 1.0f / DEFAULT_TICK_RATE; // in seconds
+    float tickAccumulator = 0;                   // time not yet simulated, carried over to the next frame
+    float tickAlpha = 0;
+
     // set to false when the game loop shouldn't run
     bool running = false;
 
-    // timing
-    float deltaTime = 0;    // time between current frame and last frame
-    time_t lastFrame = 0;   // time of last frame
+    // print render stats about once a second, toggled with F3
+#ifdef _DEBUG
+    bool showFrameStats = true;
+#else
+    bool showFrameStats = false;
+#endif
+    time_t lastFrameStatsLog = 0;
+    void logFrameStats();
 
 #ifdef USE_GLFM
     GLFMDisplay* gameDisplay;
@@ -148,8 +198,6 @@ private:
 
     void updateInput();
 
-    bool isGamePaused = false;
-
     LayerStack layerStack;
 
     static Outrospection* instance;
@@ -1,4 +1,5 @@
 #include "Outrospection.h"
+#include "Core/Random.h"
 
 #ifdef USE_GLFM
 static void onReady(GLFMDisplay *display, int width, int height) {
@@ -94,8 +95,37 @@ int main(int argc, char** argv) {
 
     glfmSetSurfaceCreatedFunc(display, onReady);
 #else
+    // --seed <n> replays a run exactly. It's read before anything else since building the game already rolls dice
+    for (int i = 1; i + 1 < argc; i++)
+    {
+        if (std::string(argv[i]) == "--seed")
+            RandomStreams::setSeed(std::strtoull(argv[i + 1], nullptr, 10));
+    }
+
     auto outrospection = Outrospection();
 
+    for (int i = 1; i < argc; i++)
+    {
+        const std::string arg = argv[i];
+
+        // --tick-rate <n> lowers or raises the simulation rate, e.g. to save CPU on slow machines
+        if (arg == "--tick-rate" && i + 1 < argc)
+            Outrospection::get().setTickRate(std::atoi(argv[++i]));
+        // --fps <n> sets the frame rate cap, 0 for uncapped
+        else if (arg == "--fps" && i + 1 < argc)
+            Outrospection::get().framePacer.setTargetRate(std::atoi(argv[++i]));
+        else if (arg == "--no-vsync")
+            Outrospection::get().setVsync(false);
+        // --threads <n> sets how many job worker threads to use, 0 for one less than the CPU has
+        else if (arg == "--threads" && i + 1 < argc)
+            Outrospection::get().jobSystem.setThreadCount(std::atoi(argv[++i]));
+        // --time-scale <x> runs the game faster or slower, e.g. to fast-forward a soak test
+        else if (arg == "--time-scale" && i + 1 < argc)
+            Outrospection::get().clock.setScale(float(std::atof(argv[++i])));
+        else if (arg == "--seed" && i + 1 < argc)
+            i++; // already handled
+    }
+
     // run the game!
     Outrospection::get().run();
 
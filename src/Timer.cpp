@@ -1,71 +1,89 @@
 #include "Timer.h"
 
-#include "Util.h"
+#include "Outrospection.h"
 
-Timer::Timer(time_t duration, bool start) : m_paused(!start), m_timeLeft(duration)
+Timer::Timer(time_t duration, bool start) : m_id(Outrospection::get().timerManager.create(duration))
 {
-    m_paused = true;
     if(start)
-        m_endTime = Util::currentTimeMillis() + m_timeLeft;
-
-    m_currentTime = Util::currentTimeMillis();
+        this->start();
 }
 
-
-void Timer::pause()
+Timer::Timer(const Timer& other) : m_id(Outrospection::get().timerManager.clone(other.m_id))
 {
-    m_paused = true;
 }
 
-void Timer::start()
+Timer::Timer(Timer&& other) noexcept : m_id(other.m_id)
 {
-    m_ended = false;
-    m_paused = false;
-    m_endTime = Util::currentTimeMillis() + m_timeLeft;
-    m_currentTime = Util::currentTimeMillis();
+    other.m_id = TimerManager::INVALID;
 }
 
-void Timer::setDuration(time_t duration)
+Timer& Timer::operator=(const Timer& other)
 {
-    m_timeLeft = duration;
+    if(this != &other)
+    {
+        TimerManager& timers = Outrospection::get().timerManager;
+
+        const TimerManager::Id copy = timers.clone(other.m_id);
+        if(m_id != TimerManager::INVALID)
+            timers.destroy(m_id);
 
-    if(!m_paused)
-        m_endTime = Util::currentTimeMillis() + m_timeLeft;
+        m_id = copy;
+    }
+
+    return *this;
 }
 
-void Timer::tick()
+Timer& Timer::operator=(Timer&& other) noexcept
 {
-    if(m_paused)
-        return;
+    if(this != &other)
+    {
+        if(m_id != TimerManager::INVALID)
+            Outrospection::get().timerManager.destroy(m_id);
 
-    time_t curTime = Util::currentTimeMillis();
+        m_id = other.m_id;
+        other.m_id = TimerManager::INVALID;
+    }
 
-    time_t deltaTime = curTime - m_currentTime;
+    return *this;
+}
 
-    m_timeLeft -= deltaTime;
+Timer::~Timer()
+{
+    if(m_id != TimerManager::INVALID)
+        Outrospection::get().timerManager.destroy(m_id);
+}
 
-    if(m_timeLeft < 0)
-    {
-        m_timeLeft = 0;
-        pause();
+void Timer::pause()
+{
+    Outrospection::get().timerManager.pause(m_id);
+}
 
-        m_ended = true;
-    }
+void Timer::start()
+{
+    Outrospection::get().timerManager.start(m_id);
+}
+
+void Timer::setDuration(time_t duration)
+{
+    Outrospection::get().timerManager.setDuration(m_id, duration);
+}
 
-    m_currentTime = curTime;
+void Timer::onExpired(TimerManager::Callback callback)
+{
+    Outrospection::get().timerManager.setCallback(m_id, std::move(callback));
 }
 
 int Timer::getSeconds()
 {
-    return int(m_timeLeft / 1000.f) % 60;
+    return int(Outrospection::get().timerManager.timeLeft(m_id) / 1000.f) % 60;
 }
 
 int Timer::getMinutes()
 {
-    return m_timeLeft / 60000.f;
+    return Outrospection::get().timerManager.timeLeft(m_id) / 60000.f;
 }
 
 bool Timer::ended()
 {
-    return m_ended;
+    return Outrospection::get().timerManager.ended(m_id);
 }
@@ -2,25 +2,30 @@
 
 #include <ctime>
 
+#include "TimerManager.h"
+
+// Counts down a duration in game time. The state lives in Outrospection's TimerManager,
+// so there's nothing to tick. Copies are independent timers that start out in the same state
 class Timer
 {
-    bool m_ended = false;
-
-    bool m_paused = true;
-
-    time_t m_endTime;
-    time_t m_timeLeft;
-    time_t m_currentTime;
+    TimerManager::Id m_id = TimerManager::INVALID;
 
 public:
     Timer(time_t duration = 0, bool start = false);
 
+    Timer(const Timer& other);
+    Timer(Timer&& other) noexcept;
+    Timer& operator=(const Timer& other);
+    Timer& operator=(Timer&& other) noexcept;
+    ~Timer();
+
     void setDuration(time_t duration);
 
     void pause();
     void start();
 
-    void tick();
+    // called when the timer runs out. Don't capture anything that can move, e.g. an element of a vector
+    void onExpired(TimerManager::Callback callback);
 
     int getSeconds();
     int getMinutes();
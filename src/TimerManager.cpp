@@ -0,0 +1,209 @@
+#include "TimerManager.h"
+
+#include <algorithm>
+
+#include "Core/GameClock.h"
+
+namespace
+{
+    // std heap functions build a max-heap, so flip the comparison to get the earliest deadline on top
+    struct LaterDeadline
+    {
+        template<typename T>
+        bool operator()(const T& a, const T& b) const
+        {
+            return a.deadline > b.deadline;
+        }
+    };
+}
+
+TimerManager::TimerManager(const GameClock& clock) : m_clock(clock)
+{
+}
+
+TimerManager::Id TimerManager::create(time_t duration)
+{
+    Id id;
+    if (!m_freeSlots.empty())
+    {
+        id = m_freeSlots.back();
+        m_freeSlots.pop_back();
+    }
+    else
+    {
+        id = Id(m_slots.size());
+        m_slots.emplace_back();
+    }
+
+    Slot& slot = m_slots[id];
+    slot.used = true;
+    slot.running = false;
+    slot.ended = false;
+    slot.timeLeft = duration;
+
+    return id;
+}
+
+TimerManager::Id TimerManager::clone(Id id)
+{
+    const Id copy = create(0);
+
+    // create() may have grown m_slots, so look the original up afterwards
+    const Slot& original = m_slots[id];
+    Slot& slot = m_slots[copy];
+
+    slot.timeLeft = original.timeLeft;
+    slot.deadline = original.deadline;
+    slot.ended = original.ended;
+
+    if (original.running)
+    {
+        slot.running = true;
+        m_running++;
+        schedule(copy);
+    }
+
+    return copy;
+}
+
+void TimerManager::destroy(Id id)
+{
+    Slot& slot = m_slots[id];
+
+    if (slot.running)
+        m_running--;
+
+    slot.running = false;
+    slot.used = false;
+    slot.generation++;
+    slot.lifetime++;
+    slot.callback.reset();
+
+    m_freeSlots.push_back(id);
+}
+
+void TimerManager::setDuration(Id id, time_t duration)
+{
+    Slot& slot = m_slots[id];
+    slot.timeLeft = duration;
+
+    if (slot.running)
+    {
+        slot.deadline = m_clock.tickNowMillis() + duration;
+        schedule(id);
+    }
+}
+
+void TimerManager::start(Id id)
+{
+    Slot& slot = m_slots[id];
+
+    if (!slot.running)
+        m_running++;
+
+    slot.ended = false;
+    slot.running = true;
+    slot.deadline = m_clock.tickNowMillis() + slot.timeLeft;
+
+    schedule(id);
+}
+
+void TimerManager::pause(Id id)
+{
+    Slot& slot = m_slots[id];
+    if (!slot.running)
+        return;
+
+    slot.timeLeft = std::max(slot.deadline - m_clock.tickNowMillis(), time_t(0));
+    slot.running = false;
+    slot.generation++; // its heap entry is stale now
+
+    m_running--;
+}
+
+void TimerManager::setCallback(Id id, Callback callback)
+{
+    m_slots[id].callback = std::move(callback);
+}
+
+time_t TimerManager::timeLeft(Id id) const
+{
+    const Slot& slot = m_slots[id];
+    if (!slot.running)
+        return slot.timeLeft;
+
+    return std::max(slot.deadline - m_clock.tickNowMillis(), time_t(0));
+}
+
+bool TimerManager::ended(Id id) const
+{
+    return m_slots[id].ended;
+}
+
+void TimerManager::tick()
+{
+    const time_t now = m_clock.tickNowMillis();
+
+    while (!m_heap.empty() && m_heap.front().deadline <= now)
+    {
+        std::pop_heap(m_heap.begin(), m_heap.end(), LaterDeadline());
+        const Entry entry = m_heap.back();
+        m_heap.pop_back();
+
+        // the timer was paused, restarted or destroyed since this entry was pushed
+        if (!isCurrent(entry))
+            continue;
+
+        Slot& slot = m_slots[entry.id];
+        slot.timeLeft = 0;
+        slot.running = false;
+        slot.ended = true;
+        slot.generation++;
+        m_running--;
+
+        if (slot.callback)
+        {
+            // the callback may create timers and grow m_slots, so don't hold on to slot
+            const uint32_t lifetime = slot.lifetime;
+            Callback callback = std::move(slot.callback);
+            callback();
+
+            // give it back for the next time the timer runs out, unless it was replaced or destroyed
+            Slot& after = m_slots[entry.id];
+            if (after.lifetime == lifetime && !after.callback)
+                after.callback = std::move(callback);
+        }
+    }
+
+    compactHeap();
+}
+
+size_t TimerManager::runningCount() const
+{
+    return m_running;
+}
+
+void TimerManager::schedule(Id id)
+{
+    Slot& slot = m_slots[id];
+    slot.generation++;
+
+    m_heap.push_back({ slot.deadline, id, slot.generation });
+    std::push_heap(m_heap.begin(), m_heap.end(), LaterDeadline());
+}
+
+bool TimerManager::isCurrent(const Entry& entry) const
+{
+    const Slot& slot = m_slots[entry.id];
+    return slot.used && slot.running && slot.generation == entry.generation;
+}
+
+void TimerManager::compactHeap()
+{
+    // pausing leaves stale entries behind. Only rebuild once they clearly outnumber the live ones
+    if (m_heap.size() < 64 || m_heap.size() < m_running * 2)
+        return;
+
+    std::erase_if(m_heap, [this](const Entry& entry) { return !isCurrent(entry); });
+    std::make_heap(m_heap.begin(), m_heap.end(), LaterDeadline());
+}
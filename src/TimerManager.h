@@ -0,0 +1,82 @@
+#pragma once
+
+#include <cstdint>
+#include <ctime>
+#include <vector>
+
+#include "Core.h"
+#include "Core/SmallFunction.h"
+
+class GameClock;
+
+// Owns the state of every ::Timer. Running timers sit in a min-heap ordered by deadline, so tick()
+// only looks at the ones that actually expired, and paused or finished timers cost nothing at all.
+// Deadlines are in GameClock tick time, so timers fire in the tick they're due in.
+class TimerManager
+{
+public:
+    using Id = uint32_t;
+    using Callback = SmallFunction<void(), 32>;
+
+    static constexpr Id INVALID = UINT32_MAX;
+
+    explicit TimerManager(const GameClock& clock);
+
+    Id create(time_t duration);
+    // a new timer in the same state as id. The expiry callback isn't copied
+    Id clone(Id id);
+    void destroy(Id id);
+
+    void setDuration(Id id, time_t duration);
+    void start(Id id);
+    void pause(Id id);
+
+    // called once when the timer runs out
+    void setCallback(Id id, Callback callback);
+
+    time_t timeLeft(Id id) const;
+    bool ended(Id id) const;
+
+    // expire every running timer whose deadline has passed
+    void tick();
+
+    size_t runningCount() const;
+
+    DISALLOW_COPY_AND_ASSIGN(TimerManager);
+private:
+    struct Slot
+    {
+        time_t timeLeft = 0; // only up to date while not running
+        time_t deadline = 0; // only meaningful while running
+
+        bool running = false;
+        bool ended = false;
+        bool used = false;
+
+        // bumped every time the deadline changes, so stale heap entries can be told apart
+        uint32_t generation = 0;
+        // bumped when the slot is destroyed, so a reused slot isn't mistaken for the old timer
+        uint32_t lifetime = 0;
+
+        Callback callback;
+    };
+
+    struct Entry
+    {
+        time_t deadline;
+        Id id;
+        uint32_t generation;
+    };
+
+    void schedule(Id id);
+    bool isCurrent(const Entry& entry) const;
+    void compactHeap();
+
+    const GameClock& m_clock;
+
+    std::vector<Slot> m_slots;
+    std::vector<Id> m_freeSlots;
+
+    std::vector<Entry> m_heap;
+    size_t m_running = 0;
+};
@@ -267,7 +267,8 @@ struct Collision
 
 struct FontCharacter
 {
-    GLuint textureId;
+    GLuint textureId; // the glyph atlas, shared by every character
+    glm::vec4 uv; // left, top, right, bottom in the atlas
     glm::ivec2 size;
     glm::ivec2 bearing; // offset from base line
     long advance; // offset to advance to next glyph
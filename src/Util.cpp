@@ -132,13 +132,9 @@ time_t Util::currentTimeMillis()
     return std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()).count();
 }
 
-Util::FutureRun::FutureRun(std::function<void()> _func, time_t _startTime, time_t _waitTime)
-    : func(_func), startTime(_startTime), waitTime(_waitTime)
-{ }
-
-void Util::doLater(std::function<void()> func, time_t waitTime)
+Scheduler::Handle Util::doLater(Scheduler::Callback func, time_t waitTime)
 {
-    Outrospection::get().futureFunctions.emplace_back(func, currentTimeMillis(), waitTime);
+    return Outrospection::get().scheduler.scheduleAt(Outrospection::get().clock.tickNowMillis() + waitTime, std::move(func));
 }
 
 std::string Util::path(const std::string& relPath)
@@ -4,6 +4,8 @@
 #include <glm.hpp>
 
 #include "Types.h"
+#include "Core/Hash.h"
+#include "Core/Scheduler.h"
 
 glm::vec3 operator*(const int& lhs, const glm::vec3& vec);
 glm::vec2 operator*(int i, const glm::vec2& vec);
@@ -79,66 +81,9 @@ namespace Util
     time_t currentTimeMillis();
 
 	// future stuff
-    struct FutureRun
-    {
-        FutureRun(std::function<void()> _func, time_t _startTime, time_t _waitTime);
-
-        std::function<void()> func;
-        time_t startTime;
-
-        time_t waitTime;
-    };
-
-    void doLater(std::function<void()> func, time_t waitTime);
-    
-    constexpr std::size_t hashBytes(const char* data, std::size_t length)
-    {
-#define get16bits(d) ((((uint32_t)(((const uint8_t *)(d))[1])) << 8) +(uint32_t)(((const uint8_t *)(d))[0]))
-
-        auto hash = uint32_t(length);
-
-        if (length <= 0 || data == nullptr) return 0;
-
-        int rem = length & 3;
-        length >>= 2;
-
-        /* Main loop */
-        for (; length > 0; length--)
-        {
-            hash += get16bits(data);
-            uint32_t tmp = (get16bits(data + 2) << 11) ^ hash;
-            hash = (hash << 16) ^ tmp;
-            data += 2 * sizeof(uint16_t);
-            hash += hash >> 11;
-        }
-
-        /* Handle end cases */
-        switch (rem)
-        {
-        case 3: hash += get16bits(data);
-            hash ^= hash << 16;
-            hash ^= ((signed char)data[sizeof(uint16_t)]) << 18;
-            hash += hash >> 11;
-            break;
-        case 2: hash += get16bits(data);
-            hash ^= hash << 11;
-            hash += hash >> 17;
-            break;
-        case 1: hash += (signed char)*data;
-            hash ^= hash << 10;
-            hash += hash >> 1;
-        }
-
-        /* Force "avalanching" of final 127 bits */
-        hash ^= hash << 3;
-        hash += hash >> 5;
-        hash ^= hash << 4;
-        hash += hash >> 17;
-        hash ^= hash << 25;
-        hash += hash >> 6;
-
-        return hash;
-    }
+    // run func in waitTime ms. Only runs while the game isn't paused. Pass the handle to
+    // Outrospection::get().scheduler.cancel() to call it off
+    Scheduler::Handle doLater(Scheduler::Callback func, time_t waitTime);
     
     std::string path(const std::string& relPath);
 
@@ -0,0 +1,224 @@
+// Texture atlas packer, run through the atlas build target whenever sprites change.
+//
+// Walks the res folder, shelf-packs the sprites of each group into pages and writes a manifest with
+// the rectangle of every sprite. TextureManager reads the manifest and composes the pages on the GPU,
+// so sprites of the same group end up sharing one texture.
+//
+// usage: atlaspacker <res folder> <output manifest>
+
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <json.hpp>
+
+#include "External/stb_image.h"
+
+namespace fs = std::filesystem;
+
+// pixels of gutter around every sprite. TextureManager extrudes the sprite's edge pixels into it
+// when it fills the page, so linear filtering at the edge samples the sprite instead of a neighbor
+constexpr int PADDING = 2;
+
+// 4096 is supported everywhere we run. TextureManager falls back to standalone textures if it isn't
+constexpr int MAX_PAGE_SIZE = 4096;
+
+struct Group
+{
+    std::string name;
+    std::string filter; // has to match the filter the game requests these textures with
+
+    std::vector<std::string> folders; // relative to res, not recursive
+    std::string prefix; // only pack files starting with this
+    std::vector<std::string> exclude;
+};
+
+// keep in sync with the simpleTexture()/animatedTexture() calls in the GUI layers
+const std::vector<Group> groups = {
+    { "costume",      "linear",  { "CostumeData/face", "CostumeData/hands", "CostumeData/hat",
+                                   "CostumeData/legs", "CostumeData/torso" }, "", { "placeholder.png" } },
+    { "ui",           "linear",  { "ObjectData/UI" }, "", { "fadeColor.png", "credits.png", "starrySky.png" } },
+    { "explosion",    "nearest", { "ObjectData" }, "explosion", {} },
+    { "goodbyeWorld", "nearest", { "ObjectData/goodbyeWorld" }, "", {} },
+};
+
+struct Sprite
+{
+    std::string path; // relative to res, with forward slashes
+    int width = 0, height = 0;
+
+    int page = 0;
+    int x = 0, y = 0;
+};
+
+struct Page
+{
+    std::string group;
+    std::string filter;
+    int width = 0, height = 0;
+};
+
+static std::vector<Sprite> collectSprites(const fs::path& resDir, const Group& group)
+{
+    std::vector<Sprite> sprites;
+
+    for (const std::string& folder : group.folders)
+    {
+        const fs::path dir = resDir / folder;
+        if (!fs::is_directory(dir))
+        {
+            printf("Warning: %s is not a folder, skipping\n", dir.string().c_str());
+            continue;
+        }
+
+        for (const auto& entry : fs::directory_iterator(dir))
+        {
+            const std::string fileName = entry.path().filename().string();
+
+            if (!entry.is_regular_file() || entry.path().extension() != ".png")
+                continue;
+
+            if (fileName.rfind(group.prefix, 0) != 0)
+                continue;
+
+            if (std::find(group.exclude.begin(), group.exclude.end(), fileName) != group.exclude.end())
+                continue;
+
+            Sprite sprite;
+            sprite.path = fs::relative(entry.path(), resDir).generic_string();
+
+            int components = 0;
+            if (!stbi_info(entry.path().string().c_str(), &sprite.width, &sprite.height, &components))
+            {
+                printf("Warning: could not read %s (%s), skipping\n", sprite.path.c_str(), stbi_failure_reason());
+                continue;
+            }
+
+            if (sprite.width + PADDING * 2 > MAX_PAGE_SIZE || sprite.height + PADDING * 2 > MAX_PAGE_SIZE)
+            {
+                printf("Warning: %s is too big for a page, skipping\n", sprite.path.c_str());
+                continue;
+            }
+
+            sprites.push_back(sprite);
+        }
+    }
+
+    return sprites;
+}
+
+// simple shelf packer: tallest sprites first, left to right, one row at a time
+static void packGroup(const Group& group, std::vector<Sprite>& sprites, std::vector<Page>& pages)
+{
+    std::sort(sprites.begin(), sprites.end(), [](const Sprite& a, const Sprite& b) {
+        if (a.height != b.height)
+            return a.height > b.height;
+
+        return a.path < b.path; // keep the output stable between runs
+    });
+
+    Page* page = nullptr;
+    int shelfX = 0, shelfY = 0, shelfHeight = 0;
+
+    for (Sprite& sprite : sprites)
+    {
+        const int w = sprite.width + PADDING * 2;
+        const int h = sprite.height + PADDING * 2;
+
+        if (page && shelfX + w > MAX_PAGE_SIZE)
+        {
+            // start a new shelf
+            shelfY += shelfHeight;
+            shelfX = 0;
+            shelfHeight = 0;
+        }
+
+        if (!page || shelfY + h > MAX_PAGE_SIZE)
+        {
+            pages.push_back({ group.name, group.filter, 0, 0 });
+            page = &pages.back();
+
+            shelfX = shelfY = shelfHeight = 0;
+        }
+
+        sprite.page = int(pages.size()) - 1;
+        sprite.x = shelfX + PADDING;
+        sprite.y = shelfY + PADDING;
+
+        shelfX += w;
+        shelfHeight = std::max(shelfHeight, h);
+
+        page->width = std::max(page->width, shelfX);
+        page->height = std::max(page->height, shelfY + shelfHeight);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    if (argc != 3)
+    {
+        printf("usage: %s <res folder> <output manifest>\n", argv[0]);
+        return 1;
+    }
+
+    const fs::path resDir = argv[1];
+
+    std::vector<Page> pages;
+    std::vector<Sprite> allSprites;
+
+    for (const Group& group : groups)
+    {
+        std::vector<Sprite> sprites = collectSprites(resDir, group);
+        packGroup(group, sprites, pages);
+
+        allSprites.insert(allSprites.end(), sprites.begin(), sprites.end());
+    }
+
+    nlohmann::ordered_json manifest;
+    manifest["version"] = 1;
+    manifest["padding"] = PADDING;
+    manifest["pages"] = nlohmann::ordered_json::array();
+    manifest["regions"] = nlohmann::ordered_json::object();
+
+    long long pixels = 0;
+    for (const Page& page : pages)
+    {
+        manifest["pages"].push_back({
+            { "group", page.group },
+            { "filter", page.filter },
+            { "width", page.width },
+            { "height", page.height },
+        });
+
+        pixels += (long long) page.width * page.height;
+    }
+
+    std::sort(allSprites.begin(), allSprites.end(), [](const Sprite& a, const Sprite& b) { return a.path < b.path; });
+    for (const Sprite& sprite : allSprites)
+    {
+        manifest["regions"][sprite.path] = {
+            { "page", sprite.page },
+            { "x", sprite.x },
+            { "y", sprite.y },
+            { "width", sprite.width },
+            { "height", sprite.height },
+        };
+    }
+
+    std::ofstream out(argv[2]);
+    if (!out)
+    {
+        printf("Failed to open %s for writing\n", argv[2]);
+        return 1;
+    }
+
+    out << manifest.dump(1, '\t') << '\n';
+
+    printf("Packed %zu sprites into %zu pages (%.1f MB of RGBA)\n", allSprites.size(), pages.size(),
+           pixels * 4 / (1024.0 * 1024.0));
+
+    return 0;
+}
@@ -0,0 +1,162 @@
+// Crowd movement microbenchmark.
+//
+// Times CrowdKernel's scalar, SSE2 and AVX2 paths against the per-object movement GUIPeople used
+// before CrowdStore: one heap-heavy UIHuman-shaped object per human, ticked one at a time with a
+// string compare for isDead() and glm vector math.
+//
+// usage: crowdbench [ticks]
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <glm.hpp>
+
+#include "Core/CrowdKernel.h"
+
+namespace
+{
+    constexpr float LERP_FACTOR = 0.01f;
+    constexpr float ARRIVE_DISTANCE = 0.05f;
+
+    // the fields UIHuman used to carry, laid out like it. Only pos, prevPos, goal and the animation are touched
+    struct LegacyHuman
+    {
+        std::string text = "Human base";
+        glm::vec2 pos, prevPos;
+        std::string curAnimation = "default";
+        std::unordered_map<std::string, std::string> animations;
+        glm::vec2 goal;
+        std::array<std::vector<std::string>, 5> layers;
+        std::array<int, 5> curLayer = {};
+        std::array<std::vector<bool>, 5> layerBad;
+        int timers[8] = {};
+        bool flip = false;
+
+        bool isDead() const
+        {
+            return curAnimation == "dead" || curAnimation == "exploding";
+        }
+
+        void tick(float lerpFactor)
+        {
+            prevPos = pos;
+
+            if (!isDead() && glm::length(goal) != 0 && pos != goal)
+                pos = pos + (goal - pos) * lerpFactor;
+
+            // what draw() computed for every human every frame
+            flip = goal.x > pos.x;
+        }
+    };
+
+    struct Soa
+    {
+        std::vector<float> posX, posY, prevX, prevY, goalX, goalY;
+        std::vector<uint8_t> moving, facingRight;
+
+        // everything integrate() writes
+        bool sameResult(const Soa& other) const
+        {
+            return posX == other.posX && posY == other.posY && moving == other.moving && facingRight == other.facingRight;
+        }
+    };
+
+    using Clock = std::chrono::steady_clock;
+
+    double nsPerHuman(Clock::duration time, size_t humans, int ticks)
+    {
+        return std::chrono::duration<double, std::nano>(time).count() / (double(humans) * ticks);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const int ticks = argc > 1 ? std::max(std::atoi(argv[1]), 1) : 200;
+
+    printf("best path on this CPU: %s, %i ticks per run\n\n", CrowdKernel::pathName(CrowdKernel::bestPath()), ticks);
+    printf("%10s %14s %14s %14s %14s\n", "humans", "per-object", "scalar", "SSE2", "AVX2");
+
+    for (const size_t count : { size_t(1000), size_t(10000), size_t(100000) })
+    {
+        std::mt19937 rng(1234);
+        std::uniform_real_distribution<float> coord(0, 1920);
+
+        std::vector<glm::vec2> starts(count), goals(count);
+        for (size_t i = 0; i < count; i++)
+        {
+            starts[i] = { coord(rng), coord(rng) };
+            goals[i] = { coord(rng), coord(rng) };
+        }
+
+        // per-object. Allocated one by one like the costumes were, so they end up spread over the heap
+        std::vector<LegacyHuman> legacy(count);
+        for (size_t i = 0; i < count; i++)
+        {
+            legacy[i].pos = legacy[i].prevPos = starts[i];
+            legacy[i].goal = goals[i];
+            legacy[i].animations = { { "default", "" }, { "exploding", "ObjectData/explosion" }, { "dead", "" } };
+            for (auto& layer : legacy[i].layers)
+                layer = { "CostumeData/hat/0", "CostumeData/hat/1", "CostumeData/hat/2", "CostumeData/hat/3" };
+        }
+
+        const Clock::time_point legacyStart = Clock::now();
+        for (int tick = 0; tick < ticks; tick++)
+        {
+            for (LegacyHuman& human : legacy)
+                human.tick(LERP_FACTOR);
+        }
+        const double legacyNs = nsPerHuman(Clock::now() - legacyStart, count, ticks);
+
+        double kernelNs[3] = {};
+        Soa reference;
+
+        for (const CrowdKernel::Path path : { CrowdKernel::Path::SCALAR, CrowdKernel::Path::SSE2, CrowdKernel::Path::AVX2 })
+        {
+            Soa soa;
+            for (size_t i = 0; i < count; i++)
+            {
+                soa.posX.push_back(starts[i].x);
+                soa.posY.push_back(starts[i].y);
+                soa.goalX.push_back(goals[i].x);
+                soa.goalY.push_back(goals[i].y);
+            }
+            soa.prevX = soa.posX;
+            soa.prevY = soa.posY;
+            soa.moving.assign(count, 1);
+            soa.facingRight.assign(count, 0);
+
+            const CrowdKernel::Crowd crowd = { soa.posX.data(), soa.posY.data(), soa.goalX.data(), soa.goalY.data(),
+                                               soa.moving.data(), soa.facingRight.data(), count };
+
+            const Clock::time_point start = Clock::now();
+            for (int tick = 0; tick < ticks; tick++)
+            {
+                // CrowdStore::beginTick
+                std::copy(soa.posX.begin(), soa.posX.end(), soa.prevX.begin());
+                std::copy(soa.posY.begin(), soa.posY.end(), soa.prevY.begin());
+
+                CrowdKernel::integrate(crowd, LERP_FACTOR, ARRIVE_DISTANCE, path);
+            }
+            kernelNs[int(path)] = nsPerHuman(Clock::now() - start, count, ticks);
+
+            // every path has to end up in exactly the same place, moving and facing the same way
+            if (path == CrowdKernel::Path::SCALAR)
+                reference = std::move(soa);
+            else if (!reference.sameResult(soa))
+                printf("warning: the %s path disagrees with the scalar one!\n", CrowdKernel::pathName(path));
+        }
+
+        printf("%10zu %11.2f ns %11.2f ns %11.2f ns %11.2f ns   (per human per tick)\n",
+               count, legacyNs, kernelNs[0], kernelNs[1], kernelNs[2]);
+    }
+
+    return 0;
+}
@@ -0,0 +1,112 @@
+// Long-session soak benchmark for the crowd storage.
+//
+// Plays a sped-up session against CrowdSlots, the same storage, life cycle and compaction code
+// CrowdStore runs in the game: humans keep arriving, a few get doomed every tick, explode and die.
+// Prints the population, the slots in use, the time per tick and the resident memory every
+// simulated ten minutes. Slots and memory should level off with the population instead of growing
+// with everyone that ever lived.
+//
+// usage: crowdsoak [minutes] [seed]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <vector>
+
+#include <glm.hpp>
+
+#include "Core/CrowdSlots.h"
+#include "Core/Random.h"
+
+#ifdef __linux__
+#include <unistd.h>
+#endif
+
+namespace
+{
+    constexpr int TICKS_PER_SECOND = 60;
+    constexpr int TICKS_PER_REPORT = TICKS_PER_SECOND * 60 * 10;
+
+    // a human every other tick, each with a small chance to get doomed every tick.
+    // The population levels off around SPAWN_CHANCE / DOOM_CHANCE
+    constexpr float SPAWN_CHANCE = 0.5f;
+    constexpr float DOOM_CHANCE = 0.5f / 2000;
+
+    constexpr float LERP_FACTOR = 0.01f;
+
+    // what CrowdStore uses, in 1080p pixels
+    const glm::vec2 HUMAN_SIZE = glm::vec2(192, 270);
+
+    double residentMegabytes()
+    {
+#ifdef __linux__
+        FILE* statm = std::fopen("/proc/self/statm", "r");
+        if (!statm)
+            return 0;
+
+        long size = 0, resident = 0;
+        const int read = std::fscanf(statm, "%ld %ld", &size, &resident);
+        std::fclose(statm);
+
+        return read == 2 ? double(resident) * sysconf(_SC_PAGESIZE) / (1024.0 * 1024.0) : 0;
+#else
+        return 0;
+#endif
+    }
+
+    using Clock = std::chrono::steady_clock;
+}
+
+int main(int argc, char** argv)
+{
+    const int minutes = argc > 1 ? std::max(std::atoi(argv[1]), 10) : 60;
+    const uint64_t seed = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 1234;
+
+    printf("%i simulated minutes at %i ticks per second, seed %llu\n\n", minutes, TICKS_PER_SECOND, (unsigned long long) seed);
+    printf("%10s %10s %10s %12s %10s\n", "minutes", "humans", "slots", "us per tick", "RSS");
+
+    CrowdSlots crowd(HUMAN_SIZE);
+    Random random(seed, 1);
+    std::vector<float> rolls;
+
+    const int ticks = minutes * 60 * TICKS_PER_SECOND;
+    Clock::time_point reportStart = Clock::now();
+    for (int tick = 1; tick <= ticks; tick++)
+    {
+        const time_t now = time_t(tick) * 1000 / TICKS_PER_SECOND;
+
+        crowd.beginTick();
+
+        if (random.chance(SPAWN_CHANCE))
+        {
+            const glm::vec2 goal(random.uniform(1100, 1800), random.uniform(200, 800));
+            crowd.spawn(glm::vec2(1050, 80), goal, CrowdSlots::Costume(), random.chance(0.2f));
+        }
+
+        // one roll per human, drawn in a batch like GUIPeople's goal rolls
+        rolls.resize(crowd.size());
+        random.fill(rolls.data(), rolls.size());
+
+        size_t roll = 0;
+        crowd.forEachSlot([&](uint32_t slot) {
+            if (rolls[roll++] < DOOM_CHANCE)
+                crowd.doom(slot, now);
+        });
+
+        crowd.move(LERP_FACTOR);
+        crowd.expireDeadlines(now, [&](uint32_t slot) { crowd.startExploding(slot, now); });
+
+        if (tick % TICKS_PER_REPORT != 0)
+            continue;
+
+        const double usPerTick = std::chrono::duration<double, std::micro>(Clock::now() - reportStart).count() / TICKS_PER_REPORT;
+        printf("%10i %10u %10zu %12.2f %7.1f MB\n", tick / (60 * TICKS_PER_SECOND), crowd.population().alive,
+               crowd.slotCount(), usPerTick, residentMegabytes());
+
+        reportStart = Clock::now();
+    }
+
+    return 0;
+}
@@ -0,0 +1,166 @@
+// Brute-force check for the crowd's spatial queries.
+//
+// Churns a CrowdSlots the way a session does, humans arriving, walking, getting doomed, exploding,
+// dying and being compacted away, and after every tick runs a few random queryRadius, queryRect,
+// nearest and humanAt queries against a plain loop over every standing human. Any disagreement is
+// printed and makes the exit code non-zero.
+//
+// usage: gridcheck [ticks] [seed]
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <vector>
+
+#include <glm.hpp>
+
+#include "Core/CrowdSlots.h"
+#include "Core/Random.h"
+
+namespace
+{
+    constexpr int TICKS_PER_SECOND = 60;
+    constexpr int QUERIES_PER_TICK = 4;
+
+    // a denser crowd than the soak test, so the queries have plenty of overlap to sort out
+    constexpr float SPAWN_CHANCE = 0.5f;
+    constexpr float DOOM_CHANCE = 0.5f / 400;
+
+    constexpr float LERP_FACTOR = 0.01f;
+
+    // what CrowdStore uses, in 1080p pixels
+    const glm::vec2 HUMAN_SIZE = glm::vec2(192, 270);
+
+    // the grid files humans by the center of their sprite, done the same way CrowdSlots does it
+    glm::vec2 centerOf(const CrowdSlots& crowd, uint32_t slot)
+    {
+        return crowd.getPos(slot) + HUMAN_SIZE / 2.0f;
+    }
+
+    // the ids of every standing human the test accepts, sorted
+    template<typename Test>
+    std::vector<uint32_t> bruteForce(const CrowdSlots& crowd, Test&& test)
+    {
+        std::vector<uint32_t> ids;
+        crowd.forEachSlot([&](uint32_t slot) {
+            if (!crowd.isDead(slot) && test(centerOf(crowd, slot)))
+                ids.push_back(crowd.idAt(slot));
+        });
+
+        std::sort(ids.begin(), ids.end());
+        return ids;
+    }
+
+    int failures = 0;
+
+    void fail(int tick, const char* query, glm::vec2 pos)
+    {
+        if (failures++ < 20)
+            printf("tick %i: %s at (%.1f, %.1f) disagrees with brute force\n", tick, query, pos.x, pos.y);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const int ticks = argc > 1 ? std::max(std::atoi(argv[1]), 1) : 60 * 60 * TICKS_PER_SECOND / 6;
+    const uint64_t seed = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 1234;
+
+    CrowdSlots crowd(HUMAN_SIZE);
+    Random random(seed, 1);
+    std::vector<uint32_t> found;
+    size_t queries = 0;
+
+    for (int tick = 1; tick <= ticks; tick++)
+    {
+        const time_t now = time_t(tick) * 1000 / TICKS_PER_SECOND;
+
+        crowd.beginTick();
+
+        if (random.chance(SPAWN_CHANCE))
+        {
+            const glm::vec2 goal(random.uniform(1100, 1800), random.uniform(200, 800));
+            crowd.spawn(glm::vec2(1050, 80), goal, CrowdSlots::Costume(), random.chance(0.2f));
+        }
+
+        crowd.forEachSlot([&](uint32_t slot) {
+            if (random.chance(DOOM_CHANCE))
+                crowd.doom(slot, now);
+        });
+
+        crowd.move(LERP_FACTOR);
+        crowd.expireDeadlines(now, [&](uint32_t slot) { crowd.startExploding(slot, now); });
+
+        for (int q = 0; q < QUERIES_PER_TICK; q++)
+        {
+            const glm::vec2 pos(random.uniform(1000, 2100), random.uniform(0, 1100));
+            const float radius = random.uniform(0, 400);
+
+            found.clear();
+            crowd.queryRadius(pos, radius, found);
+            std::sort(found.begin(), found.end());
+            if (found != bruteForce(crowd, [&](glm::vec2 center) {
+                    const glm::vec2 offset = center - pos;
+                    return glm::dot(offset, offset) <= radius * radius;
+                }))
+                fail(tick, "queryRadius", pos);
+
+            const glm::vec2 max = pos + glm::vec2(random.uniform(0, 500), random.uniform(0, 500));
+            found.clear();
+            crowd.queryRect(pos, max, found);
+            std::sort(found.begin(), found.end());
+            if (found != bruteForce(crowd, [&](glm::vec2 center) {
+                    return center.x >= pos.x && center.y >= pos.y && center.x <= max.x && center.y <= max.y;
+                }))
+                fail(tick, "queryRect", pos);
+
+            const auto distanceSq = [&](uint32_t slot) {
+                const glm::vec2 offset = centerOf(crowd, slot) - pos;
+                return glm::dot(offset, offset);
+            };
+
+            // ties can go either way, so only the distance has to match
+            float bestSq = radius * radius;
+            uint32_t best = CrowdSlots::NONE;
+            crowd.forEachSlot([&](uint32_t slot) {
+                if (!crowd.isDead(slot) && distanceSq(slot) <= bestSq)
+                {
+                    bestSq = distanceSq(slot);
+                    best = slot;
+                }
+            });
+
+            const uint32_t nearest = crowd.nearest(pos, radius);
+            if (nearest == CrowdSlots::NONE || best == CrowdSlots::NONE)
+            {
+                if (nearest != best)
+                    fail(tick, "nearest", pos);
+            }
+            else if (!crowd.contains(nearest) || crowd.isDead(crowd.slotOf(nearest)) || distanceSq(crowd.slotOf(nearest)) != bestSq)
+            {
+                fail(tick, "nearest", pos);
+            }
+
+            // the sprite drawn last, so the one in the highest slot, is the one on top
+            const glm::vec2 coverMin = pos - HUMAN_SIZE / 2.0f;
+            const glm::vec2 coverMax = pos + HUMAN_SIZE / 2.0f;
+            uint32_t top = CrowdSlots::NONE;
+            crowd.forEachSlot([&](uint32_t slot) {
+                const glm::vec2 center = centerOf(crowd, slot);
+                if (!crowd.isDead(slot) && center.x >= coverMin.x && center.y >= coverMin.y &&
+                    center.x <= coverMax.x && center.y <= coverMax.y)
+                    top = crowd.idAt(slot);
+            });
+
+            if (crowd.humanAt(pos) != top)
+                fail(tick, "humanAt", pos);
+
+            queries += 4;
+        }
+    }
+
+    printf("%i ticks, %zu queries, %i humans standing at the end, %i disagreements\n", ticks, queries,
+           int(crowd.population().alive), failures);
+
+    return failures == 0 ? 0 : 1;
+}